@@ -0,0 +1,446 @@
+// Expression compiler and stack machine
+
+#include "Expression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+
+static_assert(sizeof(int) == sizeof(std::int32_t), "the batch columns hold ints as std::int32_t");
+
+namespace
+{
+  using Expression::Instruction;
+  using Expression::OpCode;
+  using Expression::Program;
+  using Expression::Status;
+
+  // One operator of calculate(), on one pair of values, without undefined behaviour
+  Status apply(OpCode op, int a, int b, int& result)
+  {
+    std::int64_t wide {};
+    switch (op)
+    {
+    case OpCode::add:
+      wide = std::int64_t{ a } + b;
+      break;
+    case OpCode::subtract:
+      wide = std::int64_t{ a } - b;
+      break;
+    case OpCode::multiply:
+      wide = std::int64_t{ a } * b;
+      break;
+    case OpCode::divide:
+    case OpCode::remainder:
+      if (b == 0)
+        return Status::divisionByZero;
+      wide = op == OpCode::divide ? std::int64_t{ a } / b : std::int64_t{ a } % b;
+      break;
+    default:
+      assert(false && "apply(): not a binary operator");
+      return Status::syntaxError;
+    }
+    if (wide < INT_MIN || wide > INT_MAX)
+      return Status::overflow;
+    result = static_cast<int>(wide);
+    return Status::ok;
+  }
+
+  // Recursive descent, emitting the instructions of every operator once both operands are emitted:
+  //   expression = term { ("+" | "-") term }
+  //   term       = unary { ("*" | "/" | "%") unary }
+  //   unary      = "-" unary | primary
+  //   primary    = number | variable | "(" expression ")"
+  class Parser
+  {
+  private:
+    static constexpr std::size_t maxNesting { 256 };
+
+    std::string_view m_text {};
+    const std::vector<std::string>& m_variables;
+    Program& m_program;
+    std::size_t m_position {};
+    std::size_t m_nesting {};
+    Status m_status { Status::ok };
+    std::size_t m_errorPosition {};
+
+  public:
+    Parser(std::string_view text, const std::vector<std::string>& variables, Program& program)
+      : m_text { text }, m_variables { variables }, m_program { program }
+    {
+    }
+
+    Status status() const { return m_status; }
+    std::size_t errorPosition() const { return m_errorPosition; }
+
+    bool parse()
+    {
+      if (!parseExpression())
+        return false;
+      skipSpaces();
+      if (m_position != m_text.size())
+        return fail(Status::syntaxError);
+      return true;
+    }
+
+  private:
+    bool fail(Status status)
+    {
+      m_status = status;
+      m_errorPosition = m_position;
+      return false;
+    }
+
+    void skipSpaces()
+    {
+      while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t'))
+        ++m_position;
+    }
+
+    // The next character (after spaces) if it is one of chars, '\0' otherwise
+    char peek(std::string_view chars)
+    {
+      skipSpaces();
+      if (m_position < m_text.size() && chars.find(m_text[m_position]) != std::string_view::npos)
+        return m_text[m_position];
+      return '\0';
+    }
+
+    void push(OpCode op, std::int32_t operand)
+    {
+      m_program.code.push_back({ op, operand });
+    }
+
+    bool isConstant(std::size_t fromEnd) const
+    {
+      const std::vector<Instruction>& code { m_program.code };
+      return code.size() > fromEnd && code[code.size() - 1 - fromEnd].op == OpCode::pushConstant;
+    }
+
+    // Two constant operands become one constant, unless the operation fails: that is left to
+    // evaluation, which reports it for every row
+    void emitBinary(OpCode op)
+    {
+      std::vector<Instruction>& code { m_program.code };
+      int folded {};
+      if (isConstant(0) && isConstant(1) && apply(op, code[code.size() - 2].operand, code.back().operand, folded) == Status::ok)
+      {
+        code.pop_back();
+        code.back().operand = folded;
+        return;
+      }
+      code.push_back({ op, 0 });
+    }
+
+    void emitNegate()
+    {
+      std::vector<Instruction>& code { m_program.code };
+      if (isConstant(0) && code.back().operand != INT_MIN)
+      {
+        code.back().operand = -code.back().operand;
+        return;
+      }
+      code.push_back({ OpCode::negate, 0 });
+    }
+
+    bool parseExpression()
+    {
+      if (!parseTerm())
+        return false;
+      for (char op { peek("+-") }; op != '\0'; op = peek("+-"))
+      {
+        ++m_position;
+        if (!parseTerm())
+          return false;
+        emitBinary(op == '+' ? OpCode::add : OpCode::subtract);
+      }
+      return true;
+    }
+
+    bool parseTerm()
+    {
+      if (!parseUnary())
+        return false;
+      for (char op { peek("*/%") }; op != '\0'; op = peek("*/%"))
+      {
+        ++m_position;
+        if (!parseUnary())
+          return false;
+        emitBinary(op == '*' ? OpCode::multiply : op == '/' ? OpCode::divide : OpCode::remainder);
+      }
+      return true;
+    }
+
+    bool parseUnary()
+    {
+      if (peek("-") == '\0')
+        return parsePrimary();
+
+      ++m_position;
+      if (++m_nesting > maxNesting)
+        return fail(Status::syntaxError);
+      if (!parseUnary())
+        return false;
+      --m_nesting;
+      emitNegate();
+      return true;
+    }
+
+    bool parsePrimary()
+    {
+      skipSpaces();
+      if (m_position == m_text.size())
+        return fail(Status::syntaxError);
+
+      const char c { m_text[m_position] };
+      if (c == '(')
+      {
+        ++m_position;
+        if (++m_nesting > maxNesting)
+          return fail(Status::syntaxError);
+        if (!parseExpression())
+          return false;
+        --m_nesting;
+        if (peek(")") == '\0')
+          return fail(Status::syntaxError);
+        ++m_position;
+        return true;
+      }
+
+      if (c >= '0' && c <= '9')
+      {
+        const std::size_t start { m_position };
+        std::int64_t value { 0 };
+        while (m_position < m_text.size() && m_text[m_position] >= '0' && m_text[m_position] <= '9')
+        {
+          value = value * 10 + (m_text[m_position] - '0');
+          if (value > INT_MAX)
+          {
+            m_position = start;
+            return fail(Status::overflow);
+          }
+          ++m_position;
+        }
+        push(OpCode::pushConstant, static_cast<std::int32_t>(value));
+        return true;
+      }
+
+      const auto isNameChar = [](char ch) { return ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9'); };
+      if (isNameChar(c))
+      {
+        const std::size_t start { m_position };
+        while (m_position < m_text.size() && isNameChar(m_text[m_position]))
+          ++m_position;
+        const std::string_view name { m_text.substr(start, m_position - start) };
+        const auto it { std::find(m_variables.begin(), m_variables.end(), name) };
+        if (it == m_variables.end())
+        {
+          m_position = start;
+          return fail(Status::unknownVariable);
+        }
+        push(OpCode::pushVariable, static_cast<std::int32_t>(it - m_variables.begin()));
+        return true;
+      }
+
+      return fail(Status::syntaxError);
+    }
+  };
+
+  // Deepest the stack gets while running code (folding removed pushes, so this is counted at the end)
+  std::size_t maxStackDepth(const std::vector<Instruction>& code)
+  {
+    std::size_t depth { 0 };
+    std::size_t deepest { 0 };
+    for (const Instruction& instruction : code)
+    {
+      if (instruction.op == OpCode::pushConstant || instruction.op == OpCode::pushVariable)
+        deepest = std::max(deepest, ++depth);
+      else if (instruction.op != OpCode::negate)
+        --depth;
+    }
+    return deepest;
+  }
+
+  // Error of a row in evaluateBatch(): the first one, like evaluate() stops at the first one
+  constexpr std::uint8_t divisionByZeroFlag { 1 };
+  constexpr std::uint8_t overflowFlag { 2 };
+
+  // a[i] = a[i] op b[i] for the n rows of a block, flagging the rows that fail.
+  // A failed row gets an arbitrary (but defined) value and is discarded at the end.
+  // One loop per operator, with nothing but arithmetic and selects inside, so it vectorizes.
+  template <OpCode op>
+  void applyColumns(std::int32_t* a, const std::int32_t* b, std::size_t n, std::uint8_t* errors)
+  {
+    for (std::size_t i { 0 }; i < n; ++i)
+    {
+      std::uint8_t error {};
+      if constexpr (op == OpCode::divide || op == OpCode::remainder)
+      {
+        // divide by 1 instead of 0, and instead of -1 for INT_MIN / -1 (INT_MIN % -1 is 0 anyway).
+        // Bit operations rather than && and ?: keep the loop free of branches: 0 | 1 == 1, -1 ^ -2 == 1.
+        const std::int32_t zero { b[i] == 0 };
+        const std::int32_t tooLarge { (a[i] == INT_MIN) & (b[i] == -1) };
+        const std::int32_t divisor { (b[i] | zero) ^ (tooLarge * -2) };
+        error = static_cast<std::uint8_t>(zero * divisionByZeroFlag + (tooLarge & (op == OpCode::divide)) * overflowFlag);
+
+        // a double holds any int exactly and its quotient is close enough to truncate to the
+        // exact int quotient; unlike integer division, it vectorizes
+        const auto quotient { static_cast<std::int32_t>(static_cast<double>(a[i]) / divisor) };
+        a[i] = op == OpCode::divide ? quotient : a[i] - quotient * divisor;
+      }
+      else
+      {
+        const std::int64_t wide { op == OpCode::add ? std::int64_t{ a[i] } + b[i]
+                                  : op == OpCode::subtract ? std::int64_t{ a[i] } - b[i]
+                                  : std::int64_t{ a[i] } * b[i] };
+        error = static_cast<std::uint8_t>((wide != static_cast<std::int32_t>(wide)) * overflowFlag);
+        a[i] = static_cast<std::int32_t>(wide);
+      }
+      errors[i] = errors[i] ? errors[i] : error;
+    }
+  }
+
+  void applyColumns(OpCode op, std::int32_t* a, const std::int32_t* b, std::size_t n, std::uint8_t* errors)
+  {
+    switch (op)
+    {
+    case OpCode::add: applyColumns<OpCode::add>(a, b, n, errors); break;
+    case OpCode::subtract: applyColumns<OpCode::subtract>(a, b, n, errors); break;
+    case OpCode::multiply: applyColumns<OpCode::multiply>(a, b, n, errors); break;
+    case OpCode::divide: applyColumns<OpCode::divide>(a, b, n, errors); break;
+    case OpCode::remainder: applyColumns<OpCode::remainder>(a, b, n, errors); break;
+    default: assert(false && "applyColumns(): not a binary operator");
+    }
+  }
+}
+
+namespace Expression
+{
+  const char* toString(Status status)
+  {
+    switch (status)
+    {
+    case Status::ok: return "ok";
+    case Status::syntaxError: return "syntax error";
+    case Status::unknownVariable: return "unknown variable";
+    case Status::divisionByZero: return "division by zero";
+    case Status::overflow: return "overflow";
+    }
+    return "unknown status";
+  }
+
+  CompileResult compile(std::string_view text, const std::vector<std::string>& variables)
+  {
+    CompileResult result {};
+    result.program.variableCount = variables.size();
+    Parser parser { text, variables, result.program };
+    if (!parser.parse())
+    {
+      result.status = parser.status();
+      result.position = parser.errorPosition();
+      result.program = {};
+      return result;
+    }
+    result.program.maxStack = maxStackDepth(result.program.code);
+    return result;
+  }
+
+  Status evaluate(const Program& program, const int* variables, int& result)
+  {
+    assert(!program.code.empty() && "evaluate(): the program was not compiled");
+
+    // expressions rarely go deeper than this: no allocation for them
+    constexpr std::size_t localStack { 64 };
+    int local[localStack] {};
+    std::vector<int> heap {};
+    int* stack { local };
+    if (program.maxStack > localStack)
+    {
+      heap.resize(program.maxStack);
+      stack = heap.data();
+    }
+
+    std::size_t top { 0 }; // number of values on the stack
+    for (const Instruction& instruction : program.code)
+    {
+      switch (instruction.op)
+      {
+      case OpCode::pushConstant:
+        stack[top++] = instruction.operand;
+        break;
+      case OpCode::pushVariable:
+        stack[top++] = variables[instruction.operand];
+        break;
+      case OpCode::negate:
+        if (stack[top - 1] == INT_MIN)
+          return Status::overflow;
+        stack[top - 1] = -stack[top - 1];
+        break;
+      default:
+      {
+        const Status status { apply(instruction.op, stack[top - 2], stack[top - 1], stack[top - 2]) };
+        if (status != Status::ok)
+          return status;
+        --top;
+      }
+      }
+    }
+    result = stack[0];
+    return Status::ok;
+  }
+
+  std::size_t evaluateBatch(const Program& program, const int* const* columns, std::size_t rows, int* results, Status* statuses)
+  {
+    assert(!program.code.empty() && "evaluateBatch(): the program was not compiled");
+
+    // one column of batchRows values per stack slot
+    std::vector<std::int32_t> stack(program.maxStack * batchRows);
+    std::uint8_t errors[batchRows] {};
+    std::size_t failed { 0 };
+
+    for (std::size_t start { 0 }; start < rows; start += batchRows)
+    {
+      const std::size_t n { std::min(batchRows, rows - start) };
+      std::fill(errors, errors + n, std::uint8_t{ 0 });
+
+      std::size_t top { 0 };
+      for (const Instruction& instruction : program.code)
+      {
+        std::int32_t* slot { stack.data() + top * batchRows };
+        switch (instruction.op)
+        {
+        case OpCode::pushConstant:
+          std::fill(slot, slot + n, instruction.operand);
+          ++top;
+          break;
+        case OpCode::pushVariable:
+          std::memcpy(slot, columns[instruction.operand] + start, n * sizeof(std::int32_t));
+          ++top;
+          break;
+        case OpCode::negate:
+          slot -= batchRows;
+          for (std::size_t i { 0 }; i < n; ++i)
+          {
+            const auto error { static_cast<std::uint8_t>((slot[i] == INT_MIN) * overflowFlag) };
+            errors[i] = errors[i] ? errors[i] : error;
+            slot[i] = static_cast<std::int32_t>(0u - static_cast<std::uint32_t>(slot[i]));
+          }
+          break;
+        default:
+          applyColumns(instruction.op, slot - 2 * batchRows, slot - batchRows, n, errors);
+          --top;
+        }
+      }
+
+      for (std::size_t i { 0 }; i < n; ++i)
+      {
+        const std::uint8_t error { errors[i] };
+        results[start + i] = error ? 0 : stack[i];
+        statuses[start + i] = error == divisionByZeroFlag ? Status::divisionByZero : error ? Status::overflow : Status::ok;
+        failed += error != 0;
+      }
+    }
+    return failed;
+  }
+}
@@ -0,0 +1,241 @@
+// calculate() generalized: whole expressions compiled to bytecode and evaluated on columns of values
+// Build with: clang++ -std=c++17 -O3 -mavx2 main.cpp Expression.cpp -o calculate
+// Run with:   ./calculate                  one expression from the keyboard
+//             ./calculate --benchmark      calculate() per row vs the bytecode on 10M-row columns
+
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Expression.h"
+
+// calculate() of s06, the reference for the operators
+int calculate(int a, int b, char op)
+{
+  switch (op)
+  {
+  case '+':
+    return a + b;
+  case '-':
+    return a - b;
+  case '*':
+    return a * b;
+  case '/':
+    if (b != 0)
+      return a / b;
+    else
+    {
+      std::cerr << "Error: Division by zero!" << std::endl;
+      return 0;
+    }
+  case '%':
+    return a % b;
+  default:
+    std::cerr << "Error: Unknown operator!" << std::endl;
+    return 0;
+  }
+}
+
+// Evaluates text for one row, with the scalar and the batch machine, and checks they agree
+Expression::Status evaluateBoth(const std::string& text, const std::vector<std::string>& names, std::vector<int> values, int& result)
+{
+  const Expression::CompileResult compiled { Expression::compile(text, names) };
+  assert(compiled.status == Expression::Status::ok);
+
+  const Expression::Status status { Expression::evaluate(compiled.program, values.data(), result) };
+
+  std::vector<const int*> columns {};
+  for (const int& value : values)
+    columns.push_back(&value);
+  int batchResult {};
+  Expression::Status batchStatus {};
+  const std::size_t failed { Expression::evaluateBatch(compiled.program, columns.data(), 1, &batchResult, &batchStatus) };
+  assert(batchStatus == status && failed == (status != Expression::Status::ok));
+  assert(status != Expression::Status::ok || batchResult == result);
+  return status;
+}
+
+void testCompiler()
+{
+  using Expression::OpCode;
+  using Expression::Status;
+  const std::vector<std::string> names { "a", "b", "c" };
+
+  // constant parts are folded
+  Expression::CompileResult compiled { Expression::compile("1 + 2 * 3 - -(4)", names) };
+  assert(compiled.status == Status::ok && compiled.program.code.size() == 1);
+  assert(compiled.program.code[0].op == OpCode::pushConstant && compiled.program.code[0].operand == 11);
+
+  compiled = Expression::compile("a * (2 + 3) % b", names);
+  assert(compiled.status == Status::ok && compiled.program.code.size() == 5 && compiled.program.maxStack == 2);
+
+  // a constant division by zero is left to evaluation
+  compiled = Expression::compile("c + 1 / 0", names);
+  assert(compiled.status == Status::ok && compiled.program.code.size() == 5);
+
+  // errors and where they are
+  compiled = Expression::compile("a +", names);
+  assert(compiled.status == Status::syntaxError && compiled.position == 3);
+  compiled = Expression::compile("a + x", names);
+  assert(compiled.status == Status::unknownVariable && compiled.position == 4);
+  compiled = Expression::compile("(a + b", names);
+  assert(compiled.status == Status::syntaxError && compiled.position == 6);
+  compiled = Expression::compile("a b", names);
+  assert(compiled.status == Status::syntaxError && compiled.position == 2);
+  compiled = Expression::compile("2147483648", names);
+  assert(compiled.status == Status::overflow && compiled.position == 0);
+  compiled = Expression::compile(std::string(1000, '(') + "1" + std::string(1000, ')'), names);
+  assert(compiled.status == Status::syntaxError);
+}
+
+void testEvaluation()
+{
+  using Expression::Status;
+  const std::vector<std::string> names { "a", "b" };
+
+  // every operator matches calculate() wherever calculate() is defined
+  std::mt19937 rng { 42 };
+  std::uniform_int_distribution<int> value { -30000, 30000 };
+  for (int i { 0 }; i < 10000; ++i)
+  {
+    const int a { value(rng) };
+    int b { value(rng) };
+    if (b == 0)
+      b = 1;
+    for (const char op : { '+', '-', '*', '/', '%' })
+    {
+      int result {};
+      assert(evaluateBoth(std::string{ "a " } + op + " b", names, { a, b }, result) == Status::ok);
+      assert(result == calculate(a, b, op));
+    }
+  }
+
+  int result {};
+  assert(evaluateBoth("(a + b) * -b + a % 3", names, { 10, 4 }, result) == Status::ok && result == -55);
+  assert(evaluateBoth("a / (b - 4)", names, { 10, 4 }, result) == Status::divisionByZero);
+  assert(evaluateBoth("a % b", names, { 10, 0 }, result) == Status::divisionByZero);
+  assert(evaluateBoth("a + 1", names, { INT_MAX, 0 }, result) == Status::overflow);
+  assert(evaluateBoth("a * b", names, { 65536, 65536 }, result) == Status::overflow);
+  assert(evaluateBoth("a / b", names, { INT_MIN, -1 }, result) == Status::overflow);
+  assert(evaluateBoth("a % b", names, { INT_MIN, -1 }, result) == Status::ok && result == 0);
+  assert(evaluateBoth("-a", names, { INT_MIN, 0 }, result) == Status::overflow);
+  assert(evaluateBoth("-2147483647 - 1 + a", names, { 0, 0 }, result) == Status::ok && result == INT_MIN);
+
+  // a batch with failing rows in the middle: they don't disturb the others
+  const Expression::CompileResult compiled { Expression::compile("a * 1000 / b", names) };
+  constexpr std::size_t rows { 1000 };
+  std::vector<int> as(rows);
+  std::vector<int> bs(rows);
+  for (std::size_t row { 0 }; row < rows; ++row)
+  {
+    as[row] = static_cast<int>(row) * (row % 7 == 0 ? 100000 : 1);
+    bs[row] = static_cast<int>(row % 5);
+  }
+  const int* columns[] { as.data(), bs.data() };
+  std::vector<int> results(rows);
+  std::vector<Status> statuses(rows);
+  std::size_t expectedFailures { 0 };
+  const std::size_t failed { Expression::evaluateBatch(compiled.program, columns, rows, results.data(), statuses.data()) };
+  for (std::size_t row { 0 }; row < rows; ++row)
+  {
+    int expected {};
+    const Status status { Expression::evaluate(compiled.program, std::vector<int>{ as[row], bs[row] }.data(), expected) };
+    assert(statuses[row] == status);
+    assert(results[row] == (status == Status::ok ? expected : 0));
+    expectedFailures += status != Status::ok;
+  }
+  assert(failed == expectedFailures && failed > 0);
+}
+
+void benchmark()
+{
+  using Clock = std::chrono::steady_clock;
+  using Ms = std::chrono::duration<double, std::milli>;
+
+  constexpr std::size_t rows { 10'000'000 };
+  std::mt19937 rng { 42 };
+  std::uniform_int_distribution<int> value { 1, 1000 };
+  std::vector<int> a(rows);
+  std::vector<int> b(rows);
+  std::vector<int> c(rows);
+  for (std::size_t row { 0 }; row < rows; ++row)
+  {
+    a[row] = value(rng);
+    b[row] = value(rng);
+    c[row] = value(rng);
+  }
+
+  // (a + b) * c - a / b + c % 7, one calculate() per operator
+  auto start { Clock::now() };
+  std::vector<int> expected(rows);
+  for (std::size_t row { 0 }; row < rows; ++row)
+  {
+    const int product { calculate(calculate(a[row], b[row], '+'), c[row], '*') };
+    expected[row] = calculate(calculate(product, calculate(a[row], b[row], '/'), '-'), calculate(c[row], 7, '%'), '+');
+  }
+  const Ms calculateTime { Clock::now() - start };
+
+  const Expression::CompileResult compiled { Expression::compile("(a + b) * c - a / b + c % 7", { "a", "b", "c" }) };
+  assert(compiled.status == Expression::Status::ok);
+
+  start = Clock::now();
+  std::vector<int> scalar(rows);
+  for (std::size_t row { 0 }; row < rows; ++row)
+  {
+    const int variables[] { a[row], b[row], c[row] };
+    Expression::evaluate(compiled.program, variables, scalar[row]);
+  }
+  const Ms scalarTime { Clock::now() - start };
+
+  start = Clock::now();
+  std::vector<int> batch(rows);
+  std::vector<Expression::Status> statuses(rows);
+  const int* columns[] { a.data(), b.data(), c.data() };
+  const std::size_t failed { Expression::evaluateBatch(compiled.program, columns, rows, batch.data(), statuses.data()) };
+  const Ms batchTime { Clock::now() - start };
+
+  assert(scalar == expected && batch == expected && failed == 0);
+  std::cout << rows << " rows of (a + b) * c - a / b + c % 7:\n"
+            << "  calculate() per operator: " << calculateTime.count() << " ms\n"
+            << "  bytecode, row by row:     " << scalarTime.count() << " ms\n"
+            << "  bytecode, in batches:     " << batchTime.count() << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+  testCompiler();
+  testEvaluation();
+
+  if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+  {
+    benchmark();
+    return 0;
+  }
+
+  std::cout << "Enter an expression of a and b (+, -, *, /, %, parentheses): ";
+  std::string text {};
+  std::getline(std::cin, text);
+  const Expression::CompileResult compiled { Expression::compile(text, { "a", "b" }) };
+  if (compiled.status != Expression::Status::ok)
+  {
+    std::cout << "Error: " << Expression::toString(compiled.status) << " at position " << compiled.position << '\n';
+    return 1;
+  }
+
+  int values[2] {};
+  std::cout << "Enter a and b: ";
+  std::cin >> values[0] >> values[1];
+
+  int result {};
+  const Expression::Status status { Expression::evaluate(compiled.program, values, result) };
+  if (status != Expression::Status::ok)
+    std::cout << "Error: " << Expression::toString(status) << '\n';
+  else
+    std::cout << "Result: " << result << '\n';
+
+  return 0;
+}
@@ -0,0 +1,260 @@
+// Member functions of System and Integrator defined here
+
+#include "Particles.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    // Acceleration of a particle moving at (vx, vy): gravity plus quadratic drag
+    struct Acceleration
+    {
+        double gravity {};
+        double drag {};
+
+        void operator()(double vx, double vy, double& ax, double& ay) const
+        {
+            const double k { drag * std::sqrt(vx * vx + vy * vy) };
+            ax = -k * vx;
+            ay = -gravity - k * vy;
+        }
+    };
+
+    // Advances one particle by dt and returns whether it touched the ground; the method is a
+    // template parameter so that the loops calling this have no test of it inside
+    template <Particles::Method method>
+    inline bool advanceParticle(double& px, double& py, double& u, double& v, double dt, const Acceleration& acceleration, double restitution)
+    {
+        if constexpr (method == Particles::Method::semiImplicitEuler)
+        {
+            // new velocity first, then the position moves with it
+            double ax {};
+            double ay {};
+            acceleration(u, v, ax, ay);
+            u += ax * dt;
+            v += ay * dt;
+            px += u * dt;
+            py += v * dt;
+        }
+        else
+        {
+            // the forces only depend on the velocity, so the stages only need velocities
+            double ax1 {}, ay1 {}, ax2 {}, ay2 {}, ax3 {}, ay3 {}, ax4 {}, ay4 {};
+            acceleration(u, v, ax1, ay1);
+            const double u2 { u + dt / 2 * ax1 };
+            const double v2 { v + dt / 2 * ay1 };
+            acceleration(u2, v2, ax2, ay2);
+            const double u3 { u + dt / 2 * ax2 };
+            const double v3 { v + dt / 2 * ay2 };
+            acceleration(u3, v3, ax3, ay3);
+            const double u4 { u + dt * ax3 };
+            const double v4 { v + dt * ay3 };
+            acceleration(u4, v4, ax4, ay4);
+
+            px += dt / 6 * (u + 2 * u2 + 2 * u3 + u4);
+            py += dt / 6 * (v + 2 * v2 + 2 * v3 + v4);
+            u += dt / 6 * (ax1 + 2 * ax2 + 2 * ax3 + ax4);
+            v += dt / 6 * (ay1 + 2 * ay2 + 2 * ay3 + ay4);
+        }
+
+        // ground collision, written without branches so the loops stay vectorizable
+        const bool below { py < 0.0 };
+        py = below ? 0.0 : py;
+        v = (below && v < 0.0) ? -v * restitution : v;
+        return below;
+    }
+
+    // Advances particles [begin, end) by dt
+    template <Particles::Method method>
+    void integrate(double* x, double* y, double* vx, double* vy, std::size_t begin, std::size_t end,
+        double dt, const Acceleration& acceleration, double restitution)
+    {
+        for (std::size_t i { begin }; i < end; ++i)
+        {
+            double px { x[i] };
+            double py { y[i] };
+            double u { vx[i] };
+            double v { vy[i] };
+            advanceParticle<method>(px, py, u, v, dt, acceleration, restitution);
+            x[i] = px;
+            y[i] = py;
+            vx[i] = u;
+            vy[i] = v;
+        }
+    }
+
+    // Step doubling: writes particles [begin, end) after two RK4 steps of dt / 2 to the out arrays
+    // and returns the largest difference with one step of dt, over the particles off the ground
+    double integrateDoubled(const double* x, const double* y, const double* vx, const double* vy,
+        double* outX, double* outY, double* outVx, double* outVy, std::size_t begin, std::size_t end,
+        double dt, const Acceleration& acceleration, double restitution)
+    {
+        constexpr auto rk4 { Particles::Method::rungeKutta4 };
+        double largest { 0.0 };
+        for (std::size_t i { begin }; i < end; ++i)
+        {
+            double px { x[i] };
+            double py { y[i] };
+            double u { vx[i] };
+            double v { vy[i] };
+            const bool touched { advanceParticle<rk4>(px, py, u, v, dt, acceleration, restitution) };
+
+            double hx { x[i] };
+            double hy { y[i] };
+            double hu { vx[i] };
+            double hv { vy[i] };
+            const bool touchedFirst { advanceParticle<rk4>(hx, hy, hu, hv, dt / 2, acceleration, restitution) };
+            const bool touchedSecond { advanceParticle<rk4>(hx, hy, hu, hv, dt / 2, acceleration, restitution) };
+
+            const double difference { std::max(std::max(std::abs(px - hx), std::abs(py - hy)), std::max(std::abs(u - hu), std::abs(v - hv))) };
+            const bool ground { touched || touchedFirst || touchedSecond };
+            largest = std::max(largest, ground ? 0.0 : difference);
+
+            outX[i] = hx;
+            outY[i] = hy;
+            outVx[i] = hu;
+            outVy[i] = hv;
+        }
+        return largest;
+    }
+}
+
+namespace Particles
+{
+    void System::reserve(std::size_t count)
+    {
+        m_x.reserve(count);
+        m_y.reserve(count);
+        m_vx.reserve(count);
+        m_vy.reserve(count);
+    }
+
+    std::size_t System::add(double x, double y, double vx, double vy)
+    {
+        m_x.push_back(x);
+        m_y.push_back(y);
+        m_vx.push_back(vx);
+        m_vy.push_back(vy);
+        return m_x.size() - 1;
+    }
+
+    Integrator::Integrator(System& system, const Settings& settings, Method method, unsigned threads)
+        : m_system { system }
+        , m_settings { settings }
+        , m_method { method }
+        , m_threads { threads ? threads : std::max(1u, std::thread::hardware_concurrency()) }
+    {
+    }
+
+    StepStats Integrator::step(double dt)
+    {
+        const auto start { std::chrono::steady_clock::now() };
+
+        System& s { m_system };
+        const std::size_t n { s.size() };
+        double* x { s.m_x.data() };
+        double* y { s.m_y.data() };
+        double* vx { s.m_vx.data() };
+        double* vy { s.m_vy.data() };
+
+        const Acceleration acceleration { m_settings.gravity, m_settings.drag };
+        const double restitution { m_settings.restitution };
+        const Method method { m_method };
+
+        // Each thread only touches its own slice of the arrays
+        Parallel::forEachChunk(n, m_threads, [=](std::size_t begin, std::size_t end, unsigned)
+        {
+            if (method == Method::semiImplicitEuler)
+                integrate<Method::semiImplicitEuler>(x, y, vx, vy, begin, end, dt, acceleration, restitution);
+            else
+                integrate<Method::rungeKutta4>(x, y, vx, vy, begin, end, dt, acceleration, restitution);
+        });
+
+        m_time += dt;
+
+        StepStats stats {};
+        stats.particles = n;
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+        stats.latencyMs = elapsed.count() * 1000.0;
+        stats.particleStepsPerSecond = elapsed.count() > 0.0 ? static_cast<double>(n) / elapsed.count() : 0.0;
+        return stats;
+    }
+
+    StepStats Integrator::advance(double duration, const Tolerance& tolerance)
+    {
+        const auto start { std::chrono::steady_clock::now() };
+
+        System& s { m_system };
+        const std::size_t n { s.size() };
+        m_x.resize(n);
+        m_y.resize(n);
+        m_vx.resize(n);
+        m_vy.resize(n);
+
+        const Acceleration acceleration { m_settings.gravity, m_settings.drag };
+        const double restitution { m_settings.restitution };
+        std::vector<double> largest(m_threads); // per chunk, so the threads don't share a maximum
+
+        StepStats stats {};
+        stats.steps = 0;
+        double dt { m_nextDt > 0.0 ? m_nextDt : tolerance.maxDt };
+        double remaining { duration };
+        while (remaining > 0.0)
+        {
+            const bool last { dt >= remaining };
+            const double stepDt { last ? remaining : dt };
+
+            const double* x { s.m_x.data() };
+            const double* y { s.m_y.data() };
+            const double* vx { s.m_vx.data() };
+            const double* vy { s.m_vy.data() };
+            double* outX { m_x.data() };
+            double* outY { m_y.data() };
+            double* outVx { m_vx.data() };
+            double* outVy { m_vy.data() };
+            double* errors { largest.data() };
+            std::fill(largest.begin(), largest.end(), 0.0);
+            Parallel::forEachChunk(n, m_threads, [=](std::size_t begin, std::size_t end, unsigned chunk)
+            {
+                errors[chunk] = integrateDoubled(x, y, vx, vy, outX, outY, outVx, outVy, begin, end, stepDt, acceleration, restitution);
+            });
+
+            // the two half steps are 2^4 = 16 times more accurate than the whole one: their error
+            // is about a 15th of the difference
+            const double error { *std::max_element(largest.begin(), largest.end()) / 15 };
+            const bool accepted { error <= tolerance.error || stepDt <= tolerance.minDt };
+            if (accepted)
+            {
+                s.m_x.swap(m_x);
+                s.m_y.swap(m_y);
+                s.m_vx.swap(m_vx);
+                s.m_vy.swap(m_vy);
+                m_time += stepDt;
+                remaining = last ? 0.0 : remaining - stepDt;
+                ++stats.steps;
+            }
+            else
+            {
+                ++stats.rejected;
+            }
+
+            // the error of RK4 grows as dt^5: aim a little under the tolerance, and change dt by at
+            // most 5 times per step. A shortened last step says nothing new about dt.
+            const double factor { error > 0.0 ? 0.9 * std::pow(tolerance.error / error, 0.2) : 5.0 };
+            if (!(accepted && last))
+                dt = std::clamp(stepDt * std::clamp(factor, 0.2, 5.0), tolerance.minDt, tolerance.maxDt);
+        }
+        m_nextDt = dt;
+
+        stats.particles = n;
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+        stats.latencyMs = elapsed.count() * 1000.0;
+        const double particleSteps { static_cast<double>(n) * (stats.steps + stats.rejected) };
+        stats.particleStepsPerSecond = elapsed.count() > 0.0 ? particleSteps / elapsed.count() : 0.0;
+        return stats;
+    }
+}
@@ -0,0 +1,115 @@
+// Header file for a particle integrator generalizing the ball drop of question1
+// The ball drop has a closed form because the ball starts at rest and only gravity acts on it.
+// With an initial velocity, air drag and bounces on the ground, we integrate the motion
+// numerically instead, for many particles at once:
+// * every component (x, y, vx, vy) lives in its own packed std::vector, so one step is a few
+//   loops over contiguous arrays that the compiler can vectorize;
+// * semi-implicit Euler (cheap, first order) or classic Runge-Kutta 4 (exact for the drag-free
+//   case, since the trajectory is then a polynomial of degree 2), with a fixed dt, or adaptive
+//   Runge-Kutta 4 that picks dt from an error tolerance (step doubling). dt is the same for every
+//   particle, so the loops stay branch-free: the largest error of all particles chooses it;
+// * the particles are split in one chunk per thread.
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Particles
+{
+    enum class Method
+    {
+        semiImplicitEuler,
+        rungeKutta4,
+    };
+
+    struct Settings
+    {
+        double gravity { 9.8 };      // m/s^2, downwards
+        double drag { 0.0 };         // quadratic drag: acceleration -drag * |v| * v
+        double restitution { 0.0 };  // fraction of the vertical speed kept by a bounce (0: the particle stops)
+    };
+
+    // Error control of Integrator::advance()
+    struct Tolerance
+    {
+        double error { 1e-6 };  // largest error allowed per step, on any position (m) or speed (m/s)
+        double minDt { 1e-6 };  // steps are never shorter, even when the error stays too large
+        double maxDt { 0.1 };
+    };
+
+    // Timing information collected for one call to Integrator::step() or Integrator::advance()
+    struct StepStats
+    {
+        std::size_t particles {};
+        double latencyMs {};
+        double particleStepsPerSecond {};
+        int steps { 1 };     // accepted steps
+        int rejected { 0 };  // steps retried with a smaller dt (advance() only)
+    };
+
+    class System
+    {
+    private:
+        // one packed array per component, the index is the particle id; y is the height above the ground
+        std::vector<double> m_x {};
+        std::vector<double> m_y {};
+        std::vector<double> m_vx {};
+        std::vector<double> m_vy {};
+
+    public:
+        void reserve(std::size_t count);
+
+        // Adds a particle and returns its id
+        std::size_t add(double x, double y, double vx = 0.0, double vy = 0.0);
+
+        std::size_t size() const { return m_x.size(); }
+
+        double x(std::size_t id) const { return m_x[id]; }
+        double y(std::size_t id) const { return m_y[id]; }
+        double vx(std::size_t id) const { return m_vx[id]; }
+        double vy(std::size_t id) const { return m_vy[id]; }
+
+        // Integrator needs raw access to the component arrays
+        friend class Integrator;
+    };
+
+    class Integrator
+    {
+    private:
+        System& m_system;
+        Settings m_settings {};
+        Method m_method {};
+        unsigned m_threads {};
+        double m_time {};
+
+        // advance(): the next dt to try, and the result of a step until it is accepted
+        double m_nextDt {};
+        std::vector<double> m_x {};
+        std::vector<double> m_y {};
+        std::vector<double> m_vx {};
+        std::vector<double> m_vy {};
+
+    public:
+        // threads == 0 means "use every hardware thread"
+        Integrator(System& system, const Settings& settings, Method method, unsigned threads = 0);
+
+        // Advances every particle by dt seconds. A particle that ends a step under the ground is put
+        // back on it and its downward speed is reversed and scaled by the restitution.
+        StepStats step(double dt);
+
+        // Advances every particle by duration seconds with adaptive Runge-Kutta 4, whatever the
+        // method. Each step is taken both whole and as two halves; their difference estimates the
+        // error, and a step whose largest error is above the tolerance is retried with a smaller dt.
+        // Particles that touch the ground during a step are left out of the error: a bounce is a
+        // projection, not an integration error, and would otherwise hold dt at minDt.
+        StepStats advance(double duration, const Tolerance& tolerance);
+
+        double time() const { return m_time; }
+        double nextDt() const { return m_nextDt; } // the dt advance() tries first, 0 before its first call
+        unsigned threads() const { return m_threads; }
+    };
+}
+
+#endif
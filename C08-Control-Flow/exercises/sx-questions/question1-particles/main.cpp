@@ -0,0 +1,197 @@
+// Ball drop of question1 as a particle simulation
+// Build with: clang++ -std=c++17 -O3 -pthread -I../../../../external/parallel main.cpp Particles.cpp -o particles
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include "Particles.h"
+
+namespace Settings
+{
+    constexpr std::size_t particles { 1'000'000 };
+    constexpr int frames { 60 };
+    constexpr double frameTime { 1.0 / 60.0 };
+}
+
+// The closed form of question1, used as the reference
+double calculateBallHeight(double towerHeight, int seconds)
+{
+    const double gravity { 9.8 };
+
+    // Using formula: s = (u * t) + (a * t^2) / 2
+    // here u (initial velocity) = 0, so (u * t) = 0
+    const double fallDistance { gravity * (seconds * seconds) / 2.0 };
+    const double ballHeight { towerHeight - fallDistance };
+
+    // If the ball would be under the ground, place it on the ground
+    if (ballHeight < 0.0)
+        return 0.0;
+
+    return ballHeight;
+}
+
+// Without drag, both methods must follow the closed form: RK4 up to rounding,
+// semi-implicit Euler within its first-order error of gravity * dt * t / 2
+void testAgainstClosedForm(Particles::Method method, double tolerancePerSecond)
+{
+    constexpr double dt { 1.0 / 64 };
+    constexpr int stepsPerSecond { 64 };
+
+    Particles::System system {};
+    for (int tower { 0 }; tower <= 40; ++tower)
+        system.add(0.0, 25.0 * tower);
+
+    Particles::Integrator integrator { system, Particles::Settings{}, method, 3 };
+    for (int seconds { 1 }; seconds <= 12; ++seconds)
+    {
+        for (int i { 0 }; i < stepsPerSecond; ++i)
+            integrator.step(dt);
+
+        for (std::size_t id { 0 }; id < system.size(); ++id)
+        {
+            const double expected { calculateBallHeight(25.0 * static_cast<double>(id), seconds) };
+            assert(std::abs(system.y(id) - expected) <= tolerancePerSecond * seconds + 1e-9);
+        }
+    }
+}
+
+void testIntegrator()
+{
+    testAgainstClosedForm(Particles::Method::rungeKutta4, 0.0);
+    testAgainstClosedForm(Particles::Method::semiImplicitEuler, 9.8 / 64 / 2);
+
+    // initial velocity: y = h + v0 t - g t^2 / 2 and x = vx t, exact for RK4
+    Particles::System thrown {};
+    thrown.add(0.0, 10.0, 3.0, 20.0);
+    Particles::Integrator rk4 { thrown, Particles::Settings{}, Particles::Method::rungeKutta4, 1 };
+    for (int i { 0 }; i < 128; ++i)
+        rk4.step(1.0 / 64);
+    assert(std::abs(thrown.x(0) - 3.0 * 2) < 1e-9);
+    assert(std::abs(thrown.y(0) - (10.0 + 20.0 * 2 - 9.8 * 4 / 2)) < 1e-9);
+
+    // drag: a long fall ends at the terminal speed sqrt(g / drag)
+    Particles::System falling {};
+    falling.add(0.0, 1e6);
+    Particles::Settings air {};
+    air.drag = 0.01;
+    Particles::Integrator dragged { falling, air, Particles::Method::rungeKutta4, 1 };
+    for (int i { 0 }; i < 60 * 100; ++i)
+        dragged.step(1.0 / 60);
+    assert(std::abs(falling.vy(0) + std::sqrt(9.8 / 0.01)) < 1e-6);
+
+    // bounces: with a restitution below 1 the ball loses height and ends up on the ground
+    Particles::System ball {};
+    ball.add(0.0, 5.0);
+    Particles::Settings bouncy {};
+    bouncy.restitution = 0.5;
+    Particles::Integrator bouncing { ball, bouncy, Particles::Method::semiImplicitEuler, 1 };
+    double highestAfterBounce { 0.0 };
+    bool bounced { false };
+    for (int i { 0 }; i < 60 * 20; ++i)
+    {
+        bouncing.step(1.0 / 600);
+        bounced = bounced || ball.vy(0) > 0.0;
+        if (bounced)
+            highestAfterBounce = std::max(highestAfterBounce, ball.y(0));
+        assert(ball.y(0) >= 0.0);
+    }
+    assert(bounced && highestAfterBounce > 0.5 && highestAfterBounce < 5.0 * 0.5 * 0.5 + 0.1);
+}
+
+void testAdaptive()
+{
+    // without drag RK4 is exact whatever dt: advance() takes the largest steps it may
+    Particles::System thrown {};
+    thrown.add(0.0, 100.0, 3.0, 20.0);
+    Particles::Integrator free { thrown, Particles::Settings{}, Particles::Method::rungeKutta4, 1 };
+    const auto freeStats { free.advance(2.0, Particles::Tolerance{}) };
+    assert(freeStats.steps == 20 && freeStats.rejected == 0);
+    assert(std::abs(thrown.y(0) - (100.0 + 20.0 * 2 - 9.8 * 4 / 2)) < 1e-9);
+
+    // with drag: the same trajectory as a fixed dt 100 times smaller, in far fewer steps
+    Particles::Settings air {};
+    air.drag = 0.05;
+    Particles::System fixed {};
+    Particles::System adaptive {};
+    for (Particles::System* system : { &fixed, &adaptive })
+    {
+        system->add(0.0, 2000.0, 40.0, 30.0);
+        system->add(0.0, 1000.0, -10.0, 0.0);
+    }
+    Particles::Integrator fixedStep { fixed, air, Particles::Method::rungeKutta4, 1 };
+    for (int i { 0 }; i < 10 * 1000; ++i)
+        fixedStep.step(1.0 / 1000);
+    Particles::Integrator adaptiveStep { adaptive, air, Particles::Method::semiImplicitEuler, 2 }; // the method is ignored
+    Particles::Tolerance tight {};
+    tight.error = 1e-9;
+    int steps { 0 };
+    for (int second { 0 }; second < 10; ++second)
+        steps += adaptiveStep.advance(1.0, tight).steps;
+    assert(std::abs(adaptiveStep.time() - 10.0) < 1e-12);
+    assert(steps < 10 * 100);
+    for (std::size_t id { 0 }; id < 2; ++id)
+    {
+        assert(std::abs(adaptive.x(id) - fixed.x(id)) < 1e-6 && std::abs(adaptive.y(id) - fixed.y(id)) < 1e-6);
+        assert(std::abs(adaptive.vx(id) - fixed.vx(id)) < 1e-6 && std::abs(adaptive.vy(id) - fixed.vy(id)) < 1e-6);
+    }
+
+    // a looser tolerance takes fewer steps
+    Particles::System loose {};
+    loose.add(0.0, 2000.0, 40.0, 30.0);
+    Particles::Integrator looseStep { loose, air, Particles::Method::rungeKutta4, 1 };
+    Particles::Tolerance coarse {};
+    coarse.error = 1e-4;
+    coarse.maxDt = 1.0;
+    assert(looseStep.advance(10.0, coarse).steps < steps);
+
+    // bounces don't hold dt at its minimum, and the ball stays above the ground
+    Particles::System ball {};
+    ball.add(0.0, 5.0);
+    Particles::Settings bouncy {};
+    bouncy.restitution = 0.5;
+    Particles::Integrator bouncing { ball, bouncy, Particles::Method::rungeKutta4, 1 };
+    for (int frame { 0 }; frame < 60 * 5; ++frame)
+    {
+        const auto stats { bouncing.advance(1.0 / 60, Particles::Tolerance{}) };
+        assert(stats.steps <= 2 && ball.y(0) >= 0.0);
+    }
+}
+
+void benchmark(Particles::Method method, const char* name)
+{
+    std::mt19937 rng { 42 };
+    std::uniform_real_distribution<double> height { 0.0, 1000.0 };
+    std::uniform_real_distribution<double> speed { -50.0, 50.0 };
+
+    Particles::System system {};
+    system.reserve(Settings::particles);
+    for (std::size_t i { 0 }; i < Settings::particles; ++i)
+        system.add(0.0, height(rng), speed(rng), speed(rng));
+
+    Particles::Settings settings {};
+    settings.drag = 0.001;
+    settings.restitution = 0.6;
+
+    Particles::Integrator integrator { system, settings, method };
+    double totalMs { 0.0 };
+    for (int frame { 0 }; frame < Settings::frames; ++frame)
+        totalMs += integrator.step(Settings::frameTime).latencyMs;
+
+    const double steps { static_cast<double>(Settings::particles) * Settings::frames };
+    std::cout << name << ": " << Settings::particles << " particles, " << Settings::frames << " frames on "
+              << integrator.threads() << " thread(s): " << totalMs / Settings::frames << " ms per frame, "
+              << steps / (totalMs / 1000.0) / 1e6 << " M particle-steps/s\n";
+}
+
+int main()
+{
+    testIntegrator();
+    testAdaptive();
+
+    benchmark(Particles::Method::semiImplicitEuler, "semi-implicit Euler");
+    benchmark(Particles::Method::rungeKutta4, "Runge-Kutta 4");
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Deterministic Miller-Rabin implementation
+
+#include "MillerRabin.h"
+
+#include <array>
+#include <cstddef>
+
+namespace
+{
+    __extension__ typedef unsigned __int128 UInt128;
+
+    constexpr std::size_t smallPrimeCount { 64 };
+
+    constexpr std::array<std::uint64_t, smallPrimeCount> makeSmallPrimes()
+    {
+        std::array<std::uint64_t, smallPrimeCount> primes {};
+        std::size_t count { 0 };
+        for (std::uint64_t candidate { 2 }; count < smallPrimeCount; ++candidate)
+        {
+            bool prime { true };
+            for (std::size_t i { 0 }; i < count && primes[i] * primes[i] <= candidate; ++i)
+                if (candidate % primes[i] == 0)
+                    prime = false;
+            if (prime)
+                primes[count++] = candidate;
+        }
+        return primes;
+    }
+
+    // Inverse of an odd number modulo 2^64 (Newton's iteration, every step doubles the correct bits)
+    constexpr std::uint64_t inverse(std::uint64_t n)
+    {
+        std::uint64_t inv { n }; // correct to 3 bits, since n * n == 1 (mod 8) for any odd n
+        for (int i { 0 }; i < 5; ++i)
+            inv *= 2 - n * inv;
+        return inv;
+    }
+
+    // For an odd p: n is a multiple of p exactly when n * inverse(p) (mod 2^64) <= UINT64_MAX / p.
+    // That is one multiplication and one comparison instead of a division.
+    struct Divisor
+    {
+        std::uint64_t prime {};
+        std::uint64_t inverse {};
+        std::uint64_t limit {};
+    };
+
+    constexpr std::array<Divisor, smallPrimeCount - 1> makeOddDivisors()
+    {
+        constexpr std::array<std::uint64_t, smallPrimeCount> primes { makeSmallPrimes() };
+        std::array<Divisor, smallPrimeCount - 1> divisors {};
+        for (std::size_t i { 1 }; i < smallPrimeCount; ++i)
+            divisors[i - 1] = Divisor{ primes[i], inverse(primes[i]), UINT64_MAX / primes[i] };
+        return divisors;
+    }
+
+    constexpr std::array<Divisor, smallPrimeCount - 1> oddDivisors { makeOddDivisors() };
+
+    // Any composite below this has a factor among the small primes
+    constexpr std::uint64_t prefilterBound { 313 * 313 }; // 313 is the 65th prime
+
+    static_assert(makeSmallPrimes()[smallPrimeCount - 1] == 311);
+    static_assert(inverse(3) * 3 == 1 && inverse(311) * 311 == 1);
+
+    // Arithmetic modulo an odd n in Montgomery form (x is stored as x * 2^64 mod n)
+    class Montgomery
+    {
+    private:
+        std::uint64_t m_n {};
+        std::uint64_t m_nInverse {};  // n^-1 mod 2^64
+        std::uint64_t m_r2 {};        // 2^128 mod n
+        std::uint64_t m_one {};       // 1 in Montgomery form (2^64 mod n)
+
+    public:
+        explicit Montgomery(std::uint64_t n)
+            : m_n { n }
+            , m_nInverse { inverse(n) }
+            , m_r2 {}
+            , m_one { (0 - n) % n }
+        {
+            m_r2 = static_cast<std::uint64_t>(static_cast<UInt128>(m_one) * m_one % n);
+        }
+
+        std::uint64_t one() const { return m_one; }
+        std::uint64_t minusOne() const { return m_n - m_one; }
+
+        // t * 2^-64 mod n, for any t < n * 2^64
+        std::uint64_t reduce(UInt128 t) const
+        {
+            const std::uint64_t m { static_cast<std::uint64_t>(t) * m_nInverse };
+            const auto high { static_cast<std::uint64_t>(t >> 64) };
+            const auto mnHigh { static_cast<std::uint64_t>((static_cast<UInt128>(m) * m_n) >> 64) };
+            // t and m * n have the same low 64 bits, so (t - m * n) / 2^64 is just the difference of the high halves
+            return high >= mnHigh ? high - mnHigh : high - mnHigh + m_n;
+        }
+
+        std::uint64_t toMontgomery(std::uint64_t x) const { return reduce(static_cast<UInt128>(x) * m_r2); }
+        std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const { return reduce(static_cast<UInt128>(a) * b); }
+
+        std::uint64_t power(std::uint64_t base, std::uint64_t exponent) const
+        {
+            std::uint64_t result { m_one };
+            while (exponent)
+            {
+                if (exponent & 1)
+                    result = multiply(result, base);
+                base = multiply(base, base);
+                exponent >>= 1;
+            }
+            return result;
+        }
+    };
+
+    // Bases found by Jim Sinclair: enough for a deterministic test on every n < 2^64
+    constexpr std::array<std::uint64_t, 7> witnesses { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+}
+
+namespace Primes
+{
+    bool isPrime(std::uint64_t n)
+    {
+        if (n < 2)
+            return false;
+        if (n % 2 == 0)
+            return n == 2;
+
+        for (const Divisor& d : oddDivisors)
+            if (n * d.inverse <= d.limit)
+                return n == d.prime;
+
+        if (n < prefilterBound)
+            return true;
+
+        // n - 1 = d * 2^s with d odd
+        const int s { __builtin_ctzll(n - 1) };
+        const std::uint64_t d { (n - 1) >> s };
+
+        const Montgomery mont { n };
+        for (const std::uint64_t witness : witnesses)
+        {
+            const std::uint64_t a { witness % n };
+            if (a == 0)
+                continue;
+
+            std::uint64_t x { mont.power(mont.toMontgomery(a), d) };
+            if (x == mont.one() || x == mont.minusOne())
+                continue;
+
+            bool composite { true };
+            for (int i { 1 }; i < s && composite; ++i)
+            {
+                x = mont.multiply(x, x);
+                if (x == mont.minusOne())
+                    composite = false;
+            }
+            if (composite)
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,23 @@
+// Single primality queries on 64-bit numbers: deterministic Miller-Rabin
+//
+// The sieve in PrimeSieve.h is the right tool for whole ranges, but a single query on a number
+// around 1e18 would need every prime up to 1e9. Miller-Rabin answers it with a handful of modular
+// exponentiations instead:
+// * divisibility by the first 64 primes is checked first (one multiplication each), which
+//   rejects most composites right away
+// * the remaining candidates go through Miller-Rabin with a fixed set of 7 bases that is known
+//   to give exact answers for every n < 2^64
+// * modular multiplication uses the Montgomery form, so the exponentiations have no division at
+//   all: the only 128-bit one computes 2^128 mod n, once per query
+
+#ifndef MILLERRABIN_H
+#define MILLERRABIN_H
+
+#include <cstdint>
+
+namespace Primes
+{
+    bool isPrime(std::uint64_t n);
+}
+
+#endif
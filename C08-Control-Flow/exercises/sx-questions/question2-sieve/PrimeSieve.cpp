@@ -0,0 +1,166 @@
+// Segmented sieve implementation
+
+#include "PrimeSieve.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    // Largest r with r * r <= x
+    std::uint64_t isqrt(std::uint64_t x)
+    {
+        auto r { static_cast<std::uint64_t>(std::sqrt(static_cast<double>(x))) };
+        while (r * r > x)
+            --r;
+        while ((r + 1) * (r + 1) <= x)
+            ++r;
+        return r;
+    }
+}
+
+namespace Primes
+{
+    std::vector<std::uint32_t> basePrimes(std::uint64_t high)
+    {
+        std::vector<std::uint32_t> primes {};
+        if (high < 10) // no odd prime p with p * p < high
+            return primes;
+
+        const std::uint64_t limit { isqrt(high - 1) };
+
+        // composite[i] stands for 2 * i + 1
+        std::vector<bool> composite((limit + 1) / 2 + 1);
+        for (std::uint64_t p { 3 }; p * p <= limit; p += 2)
+            if (!composite[p / 2])
+                for (std::uint64_t m { p * p }; m <= limit; m += 2 * p)
+                    composite[m / 2] = true;
+
+        for (std::uint64_t p { 3 }; p <= limit; p += 2)
+            if (!composite[p / 2])
+                primes.push_back(static_cast<std::uint32_t>(p));
+
+        return primes;
+    }
+
+    SegmentedSieve::SegmentedSieve(const std::vector<std::uint32_t>& basePrimes)
+        : m_basePrimes { basePrimes }
+    {
+        m_bits.reserve(segmentBytes / sizeof(std::uint64_t));
+    }
+
+    void SegmentedSieve::sieve(std::uint64_t low, std::uint64_t high)
+    {
+        // first odd number >= max(low, 3): 1 is not prime and 2 is handled by the callers
+        low = std::max<std::uint64_t>(low, 3);
+        low |= 1;
+
+        m_low = low;
+        m_count = low < high ? static_cast<std::size_t>((high - low + 1) / 2) : 0;
+        m_bits.assign((m_count + 63) / 64, ~std::uint64_t{ 0 });
+        if (m_count % 64)
+            m_bits.back() = (std::uint64_t{ 1 } << (m_count % 64)) - 1; // no bits past the end
+
+        for (const std::uint32_t prime : m_basePrimes)
+        {
+            const std::uint64_t p { prime };
+            std::uint64_t start { p * p };
+            if (start >= high)
+                break;
+
+            // first odd multiple of p inside the segment
+            if (start < low)
+            {
+                start = (low + p - 1) / p * p;
+                if (start % 2 == 0)
+                    start += p;
+            }
+
+            // consecutive odd multiples of p are 2p apart, i.e. p bits apart
+            for (std::size_t i { static_cast<std::size_t>((start - low) / 2) }; i < m_count; i += p)
+                m_bits[i / 64] &= ~(std::uint64_t{ 1 } << (i % 64));
+        }
+    }
+
+    std::uint64_t SegmentedSieve::count() const
+    {
+        std::uint64_t total { 0 };
+        for (const std::uint64_t word : m_bits)
+            total += static_cast<std::uint64_t>(__builtin_popcountll(word));
+        return total;
+    }
+
+    std::vector<std::uint64_t> primesInRange(std::uint64_t low, std::uint64_t high)
+    {
+        std::vector<std::uint64_t> primes {};
+        forEachPrime(low, high, [&primes](std::uint64_t p) { primes.push_back(p); });
+        return primes;
+    }
+
+    std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high, unsigned threads)
+    {
+        if (low >= high)
+            return 0;
+
+        const std::vector<std::uint32_t> base { basePrimes(high) };
+
+        // Every thread gets a contiguous run of whole segments and its own segment buffer
+        const std::uint64_t segments { (high - low + SegmentedSieve::segmentSpan - 1) / SegmentedSieve::segmentSpan };
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<std::uint64_t>(threads, segments));
+
+        std::vector<std::uint64_t> partial(threads);
+        auto work = [&](unsigned t)
+        {
+            const std::uint64_t first { segments * t / threads };
+            const std::uint64_t last { segments * (t + 1) / threads };
+
+            SegmentedSieve segment { base };
+            std::uint64_t total { 0 };
+            for (std::uint64_t s { first }; s < last; ++s)
+            {
+                const std::uint64_t start { low + s * SegmentedSieve::segmentSpan };
+                const std::uint64_t end { std::min(high, start + SegmentedSieve::segmentSpan) };
+                segment.sieve(start, end);
+                total += segment.count();
+            }
+            partial[t] = total;
+        };
+
+        std::vector<std::thread> workers {};
+        for (unsigned t { 1 }; t < threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (auto& worker : workers)
+            worker.join();
+
+        std::uint64_t total { (low <= 2 && 2 < high) ? 1u : 0u };
+        for (const std::uint64_t count : partial)
+            total += count;
+        return total;
+    }
+
+    PrimeTable::PrimeTable(std::uint64_t limit)
+        : m_limit { limit }
+        , m_bits(limit / 128 + 1)
+    {
+        forEachPrime(0, limit + 1, [this](std::uint64_t p)
+        {
+            if (p != 2)
+                m_bits[p / 128] |= std::uint64_t{ 1 } << (p / 2 % 64);
+        });
+    }
+
+    bool PrimeTable::isPrime(std::uint64_t x) const
+    {
+        if (x == 2)
+            return true;
+        assert(x <= m_limit && "PrimeTable::isPrime() called past the end of the table");
+        if (x % 2 == 0)
+            return false;
+        return (m_bits[x / 128] >> (x / 2 % 64)) & 1;
+    }
+}
@@ -0,0 +1,103 @@
+// Prime numbers in bulk: a segmented Sieve of Eratosthenes
+//
+// * only odd numbers are stored, one bit each (bit i of a segment stands for low + 2 * i)
+// * the range is processed one segment at a time and every segment fits in the CPU cache,
+//   so crossing out multiples never goes to main memory
+// * the base primes (up to sqrt(high)) are computed once and shared by every segment/thread
+//
+// Ranges up to about 1e12 are practical: the base primes are then below 1e6.
+
+#ifndef PRIMESIEVE_H
+#define PRIMESIEVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Primes
+{
+    // Odd primes p with p * p < high, computed with a plain sieve
+    std::vector<std::uint32_t> basePrimes(std::uint64_t high);
+
+    class SegmentedSieve
+    {
+    public:
+        // 32 KiB of bits: matches a typical L1 data cache
+        static constexpr std::size_t segmentBytes { 32 * 1024 };
+        // How many numbers (odd and even) one segment covers
+        static constexpr std::uint64_t segmentSpan { segmentBytes * 8 * 2 };
+
+    private:
+        const std::vector<std::uint32_t>& m_basePrimes;
+        std::vector<std::uint64_t> m_bits {};
+        std::uint64_t m_low {};     // first odd number of the current segment
+        std::size_t m_count {};     // how many odd numbers the current segment holds
+
+    public:
+        // basePrimes must come from basePrimes(high), with high >= any range passed to sieve()
+        explicit SegmentedSieve(const std::vector<std::uint32_t>& basePrimes);
+
+        // Sieves the odd numbers of [low, high). high - low must be <= segmentSpan.
+        // 2 is even, so it is never part of a segment: callers handle it on their own.
+        void sieve(std::uint64_t low, std::uint64_t high);
+
+        // Number of primes in the current segment
+        std::uint64_t count() const;
+
+        // Calls fn(p) for every prime in the current segment, in increasing order
+        template <typename F>
+        void forEach(F fn) const
+        {
+            for (std::size_t w { 0 }; w < m_bits.size(); ++w)
+            {
+                std::uint64_t word { m_bits[w] };
+                while (word)
+                {
+                    const int bit { __builtin_ctzll(word) };
+                    fn(m_low + 2 * (w * 64 + static_cast<std::uint64_t>(bit)));
+                    word &= word - 1;
+                }
+            }
+        }
+    };
+
+    // Calls fn(p) for every prime p in [low, high), in increasing order
+    template <typename F>
+    void forEachPrime(std::uint64_t low, std::uint64_t high, F fn)
+    {
+        if (low <= 2 && 2 < high)
+            fn(std::uint64_t{ 2 });
+
+        const std::vector<std::uint32_t> base { basePrimes(high) };
+        SegmentedSieve segment { base };
+        for (std::uint64_t start { low }; start < high; start += SegmentedSieve::segmentSpan)
+        {
+            const std::uint64_t end { high - start > SegmentedSieve::segmentSpan ? start + SegmentedSieve::segmentSpan : high };
+            segment.sieve(start, end);
+            segment.forEach(fn);
+        }
+    }
+
+    std::vector<std::uint64_t> primesInRange(std::uint64_t low, std::uint64_t high);
+
+    // Number of primes in [low, high). threads == 0 means "use every hardware thread"
+    std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high, unsigned threads = 1);
+
+    // Bit-packed, odd-only table of [0, limit] for repeated isPrime() lookups
+    class PrimeTable
+    {
+    private:
+        std::uint64_t m_limit {};
+        std::vector<std::uint64_t> m_bits {}; // bit i stands for 2 * i + 1
+
+    public:
+        explicit PrimeTable(std::uint64_t limit);
+
+        std::uint64_t limit() const { return m_limit; }
+
+        // x must be <= limit()
+        bool isPrime(std::uint64_t x) const;
+    };
+}
+
+#endif
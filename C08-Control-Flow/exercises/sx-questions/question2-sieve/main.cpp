@@ -0,0 +1,213 @@
+// Make sure that assert triggers even if we compile in release mode
+#undef NDEBUG
+
+// Build with: clang++ -std=c++17 -O2 -pthread main.cpp PrimeSieve.cpp MillerRabin.cpp -o sieve
+
+#include <algorithm>
+#include <cassert> // for assert
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "MillerRabin.h"
+#include "PrimeSieve.h"
+
+// Same interface as question2-optimized: a single bit test up to 2^20, Miller-Rabin past the table
+bool isPrime(int x)
+{
+    static const Primes::PrimeTable table { 1 << 20 };
+    if (x < 0)
+        return false;
+    const auto value { static_cast<std::uint64_t>(x) };
+    return value <= table.limit() ? table.isPrime(value) : Primes::isPrime(value);
+}
+
+// The original O(n) version, kept for the benchmark
+bool isPrimeTrialDivision(int x)
+{
+    if (x < 2)
+        return false;
+
+    for (int i {2}; i < x; ++i)
+        if (x % i == 0)
+            return false;
+    return true;
+}
+
+// Trial division by odd numbers up to sqrt(x), to cross-check the sieve on large numbers
+bool isPrimeSlow(std::uint64_t x)
+{
+    if (x < 2)
+        return false;
+    if (x % 2 == 0)
+        return x == 2;
+    for (std::uint64_t i { 3 }; i * i <= x; i += 2)
+        if (x % i == 0)
+            return false;
+    return true;
+}
+
+template <typename F>
+double timeMs(F fn)
+{
+    const auto start { std::chrono::steady_clock::now() };
+    fn();
+    return std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count();
+}
+
+int main()
+{
+    assert(!isPrime(0)); // terminate program if isPrime(0) is true
+    assert(!isPrime(1));
+    assert(isPrime(2));  // terminate program if isPrime(2) is false
+    assert(isPrime(3));
+    assert(!isPrime(4));
+    assert(isPrime(5));
+    assert(isPrime(7));
+    assert(!isPrime(9));
+    assert(isPrime(11));
+    assert(isPrime(13));
+    assert(!isPrime(15));
+    assert(!isPrime(16));
+    assert(isPrime(17));
+    assert(isPrime(19));
+    assert(isPrime(97));
+    assert(!isPrime(99));
+    assert(isPrime(13417));
+    assert(isPrime(2000003) && !isPrime(2000001)); // past the table
+    assert(isPrime(2147483647) && !isPrime(2147483645));
+
+    // the table must agree with the original function everywhere
+    for (int x { -10 }; x < 20'000; ++x)
+        assert(isPrime(x) == isPrimeTrialDivision(x));
+
+    // range enumeration and counting
+    assert((Primes::primesInRange(0, 30) == std::vector<std::uint64_t>{ 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 }));
+    assert((Primes::primesInRange(14, 24) == std::vector<std::uint64_t>{ 17, 19, 23 }));
+    assert(Primes::primesInRange(24, 29).empty());
+    assert(Primes::countPrimes(0, 2) == 0);
+    assert(Primes::countPrimes(2, 3) == 1);
+    assert(Primes::countPrimes(0, 1'000'000) == 78'498);
+    assert(Primes::countPrimes(0, 10'000'000, 4) == 664'579);
+
+    // near the top of the supported range
+    constexpr std::uint64_t big { 1'000'000'000'000 };
+    const std::vector<std::uint64_t> bigPrimes { Primes::primesInRange(big, big + 2'000) };
+    std::size_t next { 0 };
+    for (std::uint64_t x { big }; x < big + 2'000; ++x)
+    {
+        if (isPrimeSlow(x))
+        {
+            assert(next < bigPrimes.size() && bigPrimes[next] == x);
+            ++next;
+        }
+    }
+    assert(next == bigPrimes.size());
+
+    // Miller-Rabin must agree with the sieve, and with known tricky numbers
+    const Primes::PrimeTable table { 2'000'000 };
+    for (std::uint64_t x { 0 }; x <= table.limit(); ++x)
+        assert(Primes::isPrime(x) == table.isPrime(x));
+    for (std::uint64_t x { big }; x < big + 2'000; ++x)
+        assert(Primes::isPrime(x) == isPrimeSlow(x));
+    assert(!Primes::isPrime(561));                      // Carmichael number
+    assert(!Primes::isPrime(3'215'031'751));            // strong pseudoprime to bases 2, 3, 5 and 7
+    assert(!Primes::isPrime(3'825'123'056'546'413'051)); // strong pseudoprime to every prime base up to 23
+    assert(Primes::isPrime(2'305'843'009'213'693'951));  // 2^61 - 1
+    assert(Primes::isPrime(18'446'744'073'709'551'557u)); // largest prime below 2^64
+    assert(!Primes::isPrime(UINT64_MAX));
+    assert(!Primes::isPrime(4'294'967'291ull * 4'294'967'279ull)); // product of two primes close to 2^32
+
+    std::cout << "Success!\n";
+
+    // Benchmarks
+
+    // Which strategy for which range? Random queries in [low, high):
+    // * trial division: the original O(n) isPrime(int), only where it finishes in reasonable time
+    // * sieve: sieve the whole range once, then one bit test per query (cost spread over the queries)
+    // * Miller-Rabin: every query on its own
+    struct Range
+    {
+        const char* name {};
+        std::uint64_t low {};
+        std::uint64_t high {};
+        int trialDivisionQueries {};
+    };
+    constexpr Range ranges[] {
+        { "[0, 2^16)", 0, 1u << 16, 10'000 },
+        { "[0, 2^24)", 0, 1u << 24, 200 },
+        { "[2^31 - 2^24, 2^31)", (1u << 31) - (1u << 24), 1u << 31, 3 },
+        { "[2^40, 2^40 + 2^24)", 1ull << 40, (1ull << 40) + (1u << 24), 0 },
+        { "[0, 2^64)", 0, UINT64_MAX, 0 },
+    };
+    constexpr int queries { 1'000'000 };
+    std::mt19937_64 rng { 42 };
+
+    std::cout << "ns per query, " << queries << " random queries per range\n";
+    for (const Range& range : ranges)
+    {
+        std::uniform_int_distribution<std::uint64_t> pick { range.low, range.high - 1 };
+        std::vector<std::uint64_t> values(queries);
+        for (auto& v : values)
+            v = pick(rng);
+
+        int mrCount { 0 };
+        const double mrMs { timeMs([&] { for (const auto v : values) mrCount += Primes::isPrime(v); }) };
+        std::cout << "  " << range.name << ": Miller-Rabin " << mrMs * 1e6 / queries;
+
+        if (range.trialDivisionQueries > 0)
+        {
+            int count { 0 };
+            const double ms { timeMs([&] {
+                for (int i { 0 }; i < range.trialDivisionQueries; ++i)
+                    count += isPrimeTrialDivision(static_cast<int>(values[static_cast<std::size_t>(i)]));
+            }) };
+            int expected { 0 };
+            for (int i { 0 }; i < range.trialDivisionQueries; ++i)
+                expected += Primes::isPrime(values[static_cast<std::size_t>(i)]);
+            assert(count == expected);
+            std::cout << ", trial division " << ms * 1e6 / range.trialDivisionQueries;
+        }
+
+        if (range.high - range.low <= (1u << 24))
+        {
+            std::vector<std::uint64_t> primes {};
+            int sieveCount { 0 };
+            const double sieveMs { timeMs([&] {
+                primes = Primes::primesInRange(range.low, range.high);
+                for (const auto v : values)
+                    sieveCount += std::binary_search(primes.begin(), primes.end(), v);
+            }) };
+            assert(sieveCount == mrCount);
+            std::cout << ", sieve " << sieveMs * 1e6 / queries;
+        }
+        std::cout << '\n';
+    }
+
+    constexpr int smallLimit { 100'000 };
+    int slowCount { 0 };
+    int tableCount { 0 };
+    const double slowMs { timeMs([&] { for (int x { 0 }; x < smallLimit; ++x) slowCount += isPrimeTrialDivision(x); }) };
+    const double tableMs { timeMs([&] { for (int x { 0 }; x < smallLimit; ++x) tableCount += isPrime(x); }) };
+    assert(slowCount == tableCount);
+    std::cout << "isPrime(x) for every x < " << smallLimit << ": " << slowMs << " ms (trial division) vs "
+              << tableMs << " ms (table)\n";
+
+    constexpr std::uint64_t limit { 1'000'000'000 };
+    const unsigned threads { std::max(1u, std::thread::hardware_concurrency()) };
+    std::uint64_t single {};
+    std::uint64_t multi {};
+    const double singleMs { timeMs([&] { single = Primes::countPrimes(0, limit, 1); }) };
+    const double multiMs { timeMs([&] { multi = Primes::countPrimes(0, limit, threads); }) };
+    assert(single == 50'847'534 && multi == single);
+    std::cout << "pi(" << limit << ") = " << single << ": " << singleMs << " ms (1 thread), "
+              << multiMs << " ms (" << threads << " threads)\n";
+
+    std::uint64_t window {};
+    const double windowMs { timeMs([&] { window = Primes::countPrimes(big, big + 100'000'000, threads); }) };
+    std::cout << "primes in [1e12, 1e12 + 1e8): " << window << " in " << windowMs << " ms\n";
+
+    return 0;
+}
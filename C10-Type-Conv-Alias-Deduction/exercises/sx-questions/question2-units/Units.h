@@ -0,0 +1,155 @@
+// Angles as distinct types, and conversions of whole arrays of them
+//
+// With `using Degrees = double` and `using Radians = double`, `radians = degrees` compiles (question
+// 2b) and nothing checks that a value went through convertToRadians(). Here every unit is its own
+// type, Angle<Unit>, which holds a single double:
+// * mixing units doesn't compile; convert<To>() is the only way across, and its factor is a
+//   compile-time constant, so a conversion costs one multiplication, like the alias version;
+// * pi has every digit a double can hold (3.14159 is already off in the 6th digit);
+// * Angle<Unit> has the size and layout of a double, so an array of them can be converted as an
+//   array of doubles: convert() on arrays is a multiplication loop that the compiler vectorizes,
+//   and for arrays larger than the caches it writes with non-temporal (streaming) stores (-mavx),
+//   which skip reading the destination into the cache first. It runs at memory bandwidth.
+
+#ifndef UNITS_H
+#define UNITS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace Units
+{
+    // pi to the precision of a double
+    inline constexpr double pi { 3.141592653589793238462643383279502884 };
+
+    // Every unit says how much of it makes one full turn
+    struct DegreeUnit { static constexpr double perTurn { 360.0 }; };
+    struct RadianUnit { static constexpr double perTurn { 2.0 * pi }; };
+    struct GradianUnit { static constexpr double perTurn { 400.0 }; };
+    struct TurnUnit { static constexpr double perTurn { 1.0 }; };
+
+    template <typename Unit>
+    class Angle
+    {
+    private:
+        double m_value {};
+
+    public:
+        constexpr Angle() = default;
+        constexpr explicit Angle(double value) : m_value { value } {}
+
+        constexpr double value() const { return m_value; }
+
+        constexpr Angle& operator+=(Angle other) { m_value += other.m_value; return *this; }
+        constexpr Angle& operator-=(Angle other) { m_value -= other.m_value; return *this; }
+        constexpr Angle& operator*=(double factor) { m_value *= factor; return *this; }
+
+        friend constexpr Angle operator+(Angle a, Angle b) { return a += b; }
+        friend constexpr Angle operator-(Angle a, Angle b) { return a -= b; }
+        friend constexpr Angle operator-(Angle a) { return Angle{ -a.m_value }; }
+        friend constexpr Angle operator*(Angle a, double factor) { return a *= factor; }
+        friend constexpr Angle operator*(double factor, Angle a) { return a *= factor; }
+        friend constexpr double operator/(Angle a, Angle b) { return a.m_value / b.m_value; }
+
+        friend constexpr bool operator==(Angle a, Angle b) { return a.m_value == b.m_value; }
+        friend constexpr bool operator!=(Angle a, Angle b) { return a.m_value != b.m_value; }
+        friend constexpr bool operator<(Angle a, Angle b) { return a.m_value < b.m_value; }
+        friend constexpr bool operator>(Angle a, Angle b) { return a.m_value > b.m_value; }
+        friend constexpr bool operator<=(Angle a, Angle b) { return a.m_value <= b.m_value; }
+        friend constexpr bool operator>=(Angle a, Angle b) { return a.m_value >= b.m_value; }
+    };
+
+    using Degrees = Angle<DegreeUnit>;
+    using Radians = Angle<RadianUnit>;
+    using Gradians = Angle<GradianUnit>;
+    using Turns = Angle<TurnUnit>;
+
+    // the array conversions rely on this
+    static_assert(sizeof(Degrees) == sizeof(double) && std::is_trivially_copyable_v<Degrees> && std::is_standard_layout_v<Degrees>);
+
+    // What a value in From is multiplied by to be in To, folded by the compiler
+    template <typename To, typename From>
+    inline constexpr double factor { To::perTurn / From::perTurn };
+
+    // Exact where it matters: 180 degrees is pi radians
+    template <>
+    inline constexpr double factor<RadianUnit, DegreeUnit> { pi / 180.0 };
+    template <>
+    inline constexpr double factor<DegreeUnit, RadianUnit> { 180.0 / pi };
+
+    template <typename To, typename From>
+    constexpr Angle<To> convert(Angle<From> angle)
+    {
+        return Angle<To>{ angle.value() * factor<To, From> };
+    }
+
+    namespace detail
+    {
+        // Arrays at least this large don't fit in the caches: write them with streaming stores
+        constexpr std::size_t streamingBytes { 8 * 1024 * 1024 };
+
+        // out[i] = in[i] * factor; in and out are the same array or don't overlap
+        inline void scale(const double* in, double* out, std::size_t count, double factor)
+        {
+            std::size_t i { 0 };
+#if defined(__AVX__)
+            if (count * sizeof(double) >= streamingBytes && in != out)
+            {
+                // one at a time up to a 32-byte aligned destination, as streaming stores need
+                for (; i < count && reinterpret_cast<std::uintptr_t>(out + i) % 32 != 0; ++i)
+                    out[i] = in[i] * factor;
+
+                const __m256d factors { _mm256_set1_pd(factor) };
+                for (; i + 16 <= count; i += 16)
+                {
+                    const __m256d a { _mm256_loadu_pd(in + i) };
+                    const __m256d b { _mm256_loadu_pd(in + i + 4) };
+                    const __m256d c { _mm256_loadu_pd(in + i + 8) };
+                    const __m256d d { _mm256_loadu_pd(in + i + 12) };
+                    _mm256_stream_pd(out + i, _mm256_mul_pd(a, factors));
+                    _mm256_stream_pd(out + i + 4, _mm256_mul_pd(b, factors));
+                    _mm256_stream_pd(out + i + 8, _mm256_mul_pd(c, factors));
+                    _mm256_stream_pd(out + i + 12, _mm256_mul_pd(d, factors));
+                }
+                _mm_sfence(); // streaming stores are weakly ordered: make them visible before returning
+            }
+#endif
+            // the compiler vectorizes this loop
+            for (; i < count; ++i)
+                out[i] = in[i] * factor;
+        }
+    }
+
+    // Converts count angles; in and out must be the same array or not overlap
+    template <typename To, typename From>
+    void convert(const Angle<From>* in, Angle<To>* out, std::size_t count)
+    {
+        detail::scale(reinterpret_cast<const double*>(in), reinterpret_cast<double*>(out), count, factor<To, From>);
+    }
+
+    // The same on plain doubles, for data that arrives as raw numbers (sensor buffers, files)
+    template <typename To, typename From>
+    void convert(const double* in, double* out, std::size_t count)
+    {
+        detail::scale(in, out, count, factor<To, From>);
+    }
+
+    namespace literals
+    {
+        constexpr Degrees operator""_deg(long double value) { return Degrees{ static_cast<double>(value) }; }
+        constexpr Degrees operator""_deg(unsigned long long value) { return Degrees{ static_cast<double>(value) }; }
+        constexpr Radians operator""_rad(long double value) { return Radians{ static_cast<double>(value) }; }
+        constexpr Radians operator""_rad(unsigned long long value) { return Radians{ static_cast<double>(value) }; }
+        constexpr Gradians operator""_grad(long double value) { return Gradians{ static_cast<double>(value) }; }
+        constexpr Gradians operator""_grad(unsigned long long value) { return Gradians{ static_cast<double>(value) }; }
+        constexpr Turns operator""_turn(long double value) { return Turns{ static_cast<double>(value) }; }
+        constexpr Turns operator""_turn(unsigned long long value) { return Turns{ static_cast<double>(value) }; }
+    }
+}
+
+#endif
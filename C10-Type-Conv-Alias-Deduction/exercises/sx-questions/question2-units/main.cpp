@@ -0,0 +1,129 @@
+// Question 2 with a type per unit, and conversions of whole sensor arrays
+// Build with: clang++ -std=c++17 -O2 -mavx2 main.cpp -o units
+// Run with:   ./units                  question 2: degrees to radians
+//             ./units --benchmark      per value vs the array kernel (2 x 256 MiB of angles)
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Units.h"
+
+using namespace Units::literals;
+
+// convertToRadians() of question 2, the reference
+namespace constants
+{
+    constexpr double pi { 3.14159 };
+}
+
+double convertToRadians(double degrees)
+{
+    return degrees * constants::pi / 180;
+}
+
+// Question 2b) no longer compiles: Degrees and Radians are different types
+static_assert(!std::is_convertible_v<Units::Degrees, Units::Radians>);
+static_assert(!std::is_convertible_v<double, Units::Degrees>); // the constructor is explicit
+static_assert(!std::is_assignable_v<Units::Radians&, Units::Degrees>);
+
+// Conversions are constant expressions
+static_assert(Units::convert<Units::RadianUnit>(180_deg) == Units::Radians{ Units::pi });
+static_assert(Units::convert<Units::DegreeUnit>(Units::Radians{ Units::pi }) == 180_deg);
+static_assert(Units::convert<Units::GradianUnit>(90_deg) == 100_grad);
+static_assert(Units::convert<Units::TurnUnit>(720_deg) == 2_turn);
+static_assert(Units::convert<Units::DegreeUnit>(0.25_turn) == 90_deg);
+static_assert(45_deg + 45_deg == 90_deg && 2 * 45_deg == 90_deg && 90_deg / 45_deg == 2.0);
+
+void testArrays()
+{
+    std::mt19937 rng { 42 };
+    std::uniform_real_distribution<double> angle { -720.0, 720.0 };
+
+    // small arrays, from every alignment, and one large enough for the streaming stores
+    for (const std::size_t count : { std::size_t{ 0 }, std::size_t{ 1 }, std::size_t{ 37 }, std::size_t{ 1'500'001 } })
+    {
+        for (std::size_t offset { 0 }; offset < 4; ++offset)
+        {
+            std::vector<Units::Degrees> degrees(count + offset);
+            for (auto& value : degrees)
+                value = Units::Degrees{ angle(rng) };
+            std::vector<Units::Radians> radians(count + offset);
+
+            Units::convert(degrees.data() + offset, radians.data() + offset, count);
+            for (std::size_t i { offset }; i < count + offset; ++i)
+                assert(radians[i] == Units::convert<Units::RadianUnit>(degrees[i]));
+
+            // in place, on raw doubles
+            std::vector<double> raw(count);
+            for (std::size_t i { 0 }; i < count; ++i)
+                raw[i] = degrees[i + offset].value();
+            Units::convert<Units::RadianUnit, Units::DegreeUnit>(raw.data(), raw.data(), count);
+            for (std::size_t i { 0 }; i < count; ++i)
+                assert(raw[i] == radians[i + offset].value());
+        }
+    }
+}
+
+void benchmark()
+{
+    using Clock = std::chrono::steady_clock;
+    using Seconds = std::chrono::duration<double>;
+
+    constexpr std::size_t count { 32 * 1024 * 1024 }; // 256 MiB of readings
+    std::vector<double> degrees(count);
+    std::mt19937 rng { 42 };
+    std::uniform_real_distribution<double> angle { 0.0, 360.0 };
+    for (double& value : degrees)
+        value = angle(rng);
+    std::vector<double> radians(count, 0.0); // touched once, so no page faults are timed
+
+    // bytes read and written, per second
+    const auto report = [](const char* name, Seconds time)
+    {
+        std::cout << "  " << name << time.count() * 1000 << " ms, " << 2.0 * count * sizeof(double) / time.count() / 1e9 << " GB/s\n";
+    };
+
+    std::cout << count << " angles:\n";
+
+    auto start { Clock::now() };
+    for (std::size_t i { 0 }; i < count; ++i)
+        radians[i] = convertToRadians(degrees[i]);
+    report("convertToRadians() per value: ", Clock::now() - start);
+    const double checksum { radians[count / 2] };
+
+    start = Clock::now();
+    Units::convert<Units::RadianUnit, Units::DegreeUnit>(degrees.data(), radians.data(), count);
+    report("Units::convert() on the array: ", Clock::now() - start);
+    assert(std::abs(radians[count / 2] - checksum) < 1e-5); // 3.14159 is that far off
+
+    start = Clock::now();
+    std::memcpy(radians.data(), degrees.data(), count * sizeof(double));
+    report("memcpy(), for reference:       ", Clock::now() - start);
+}
+
+int main(int argc, char* argv[])
+{
+    testArrays();
+
+    if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+    {
+        benchmark();
+        return 0;
+    }
+
+    std::cout << "Enter a number of degrees: ";
+    double input {};
+    std::cin >> input;
+
+    const Units::Degrees degrees { input };
+    const Units::Radians radians { Units::convert<Units::RadianUnit>(degrees) };
+    std::cout << degrees.value() << " degrees is " << radians.value() << " radians.\n";
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+// Factorials, binomial coefficients, permutations and multinomials, in the spirit of factorial<N>()
+//
+// factorial<N>() multiplies into an int, which silently overflows past 12!. Here:
+// * every product goes through __builtin_mul_overflow, so an overflow is detected instead of
+//   wrapping: the template versions (factorial<T, N>(), binomial<T, N, K>()) fail to compile, and
+//   the function versions return an empty std::optional;
+// * T is std::uint64_t or uint128 (unsigned __int128, a GCC and Clang extension), which holds
+//   every factorial up to 34! and every binomial coefficient up to C(131, k);
+// * all the values that fit in T are computed at compile time into tables (factorials<T>,
+//   the rows of Pascal's triangle in binomials<T>), so a runtime call is a bounds check and a load.
+// Beyond the tables the functions compute the value with checked arithmetic, still never wrapping.
+
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <type_traits>
+
+namespace ConstexprCombinatorics
+{
+    __extension__ typedef unsigned __int128 uint128;
+
+    template <typename T>
+    constexpr bool isSupported { std::is_same_v<T, std::uint64_t> || std::is_same_v<T, uint128> };
+
+    // a * b, or nothing when it doesn't fit in T
+    template <typename T>
+    constexpr std::optional<T> multiply(T a, T b)
+    {
+        T product {};
+        if (__builtin_mul_overflow(a, b, &product))
+            return std::nullopt;
+        return product;
+    }
+
+    template <typename T>
+    constexpr T gcd(T a, T b)
+    {
+        while (b != 0)
+        {
+            const T rest { a % b };
+            a = b;
+            b = rest;
+        }
+        return a;
+    }
+
+    // Largest n with n! in T
+    template <typename T>
+    constexpr std::size_t maxFactorial()
+    {
+        static_assert(isSupported<T>, "Combinatorics work on std::uint64_t and uint128");
+        T value { 1 };
+        std::size_t n { 0 };
+        while (true)
+        {
+            const std::optional<T> next { multiply(value, static_cast<T>(n + 1)) };
+            if (!next)
+                return n;
+            value = *next;
+            ++n;
+        }
+    }
+
+    // Largest n with every C(n, k) in T: Pascal's triangle row by row, until an addition overflows
+    template <typename T>
+    constexpr std::size_t maxBinomialRow()
+    {
+        static_assert(isSupported<T>, "Combinatorics work on std::uint64_t and uint128");
+        constexpr std::size_t rowLimit { 256 }; // past the last row of uint128
+        T row[rowLimit] {};
+        row[0] = 1;
+        for (std::size_t n { 1 }; n < rowLimit; ++n)
+        {
+            // row n from row n - 1 in place, from the right
+            for (std::size_t k { n }; k > 0; --k)
+            {
+                if (__builtin_add_overflow(row[k], row[k - 1], &row[k]))
+                    return n - 1;
+            }
+        }
+        return rowLimit - 1;
+    }
+
+    template <typename T>
+    constexpr std::array<T, maxFactorial<T>() + 1> makeFactorials()
+    {
+        std::array<T, maxFactorial<T>() + 1> table {};
+        table[0] = 1;
+        for (std::size_t n { 1 }; n < table.size(); ++n)
+            table[n] = table[n - 1] * static_cast<T>(n);
+        return table;
+    }
+
+    template <typename T>
+    inline constexpr std::array<T, maxFactorial<T>() + 1> factorials { makeFactorials<T>() };
+
+    // Pascal's triangle up to maxBinomialRow<T>(), row after row: C(n, k) is at n * (n + 1) / 2 + k
+    constexpr std::size_t triangleIndex(std::size_t n, std::size_t k) { return n * (n + 1) / 2 + k; }
+
+    template <typename T>
+    using BinomialTable = std::array<T, triangleIndex(maxBinomialRow<T>() + 1, 0)>;
+
+    template <typename T>
+    constexpr BinomialTable<T> makeBinomials()
+    {
+        BinomialTable<T> table {};
+        for (std::size_t n { 0 }; n <= maxBinomialRow<T>(); ++n)
+        {
+            table[triangleIndex(n, 0)] = 1;
+            table[triangleIndex(n, n)] = 1;
+            for (std::size_t k { 1 }; k < n; ++k)
+                table[triangleIndex(n, k)] = table[triangleIndex(n - 1, k - 1)] + table[triangleIndex(n - 1, k)];
+        }
+        return table;
+    }
+
+    template <typename T>
+    inline constexpr BinomialTable<T> binomials { makeBinomials<T>() };
+
+    // n!, or nothing when it doesn't fit in T
+    template <typename T = std::uint64_t>
+    constexpr std::optional<T> factorial(std::size_t n)
+    {
+        if (n >= factorials<T>.size())
+            return std::nullopt;
+        return factorials<T>[n];
+    }
+
+    // C(n, k): the ways to choose k of n items, or nothing when it doesn't fit in T
+    template <typename T = std::uint64_t>
+    constexpr std::optional<T> binomial(std::uint64_t n, std::uint64_t k)
+    {
+        if (k > n)
+            return T{ 0 };
+        if (n <= maxBinomialRow<T>())
+            return binomials<T>[triangleIndex(static_cast<std::size_t>(n), static_cast<std::size_t>(k))];
+
+        // past the table: C(n, i) = C(n, i - 1) * (n - i + 1) / i, with the smaller k, reduced by
+        // the gcd so the partial products only overflow when they must
+        if (k > n - k)
+            k = n - k;
+        T result { 1 };
+        for (std::uint64_t i { 1 }; i <= k; ++i)
+        {
+            T factor { static_cast<T>(n - k + i) };
+            T divisor { static_cast<T>(i) };
+            const T common { gcd(result, divisor) };
+            result /= common;
+            divisor /= common;
+            factor /= divisor; // exact: C(n - k + i, i) is an integer and result no longer shares a factor with divisor
+            const std::optional<T> next { multiply(result, factor) };
+            if (!next)
+                return std::nullopt;
+            result = *next;
+        }
+        return result;
+    }
+
+    // n! / (n - k)!: the ordered ways to pick k of n items, or nothing when it doesn't fit in T
+    template <typename T = std::uint64_t>
+    constexpr std::optional<T> permutations(std::uint64_t n, std::uint64_t k)
+    {
+        if (k > n)
+            return T{ 0 };
+        if (n < factorials<T>.size())
+            return factorials<T>[n] / factorials<T>[n - k];
+
+        T result { 1 };
+        for (std::uint64_t i { n - k + 1 }; i <= n; ++i)
+        {
+            const std::optional<T> next { multiply(result, static_cast<T>(i)) };
+            if (!next)
+                return std::nullopt;
+            result = *next;
+        }
+        return result;
+    }
+
+    // (k1 + k2 + ...)! / (k1! k2! ...): the ways to split items into groups of the given sizes,
+    // computed as C(k1, k1) C(k1 + k2, k2) ..., or nothing when it doesn't fit in T
+    template <typename T = std::uint64_t>
+    constexpr std::optional<T> multinomial(std::initializer_list<std::uint64_t> counts)
+    {
+        T result { 1 };
+        std::uint64_t total { 0 };
+        for (const std::uint64_t count : counts)
+        {
+            total += count;
+            const std::optional<T> choose { binomial<T>(total, count) };
+            if (!choose)
+                return std::nullopt;
+            const std::optional<T> next { multiply(result, *choose) };
+            if (!next)
+                return std::nullopt;
+            result = *next;
+        }
+        return result;
+    }
+
+    // The same with the arguments as template parameters: a constant, or a compile error on overflow
+    template <typename T, std::size_t N>
+    constexpr T factorial()
+    {
+        static_assert(N <= maxFactorial<T>(), "N! does not fit in T");
+        return factorials<T>[N];
+    }
+
+    template <typename T, std::uint64_t N, std::uint64_t K>
+    constexpr T binomial()
+    {
+        constexpr std::optional<T> value { binomial<T>(N, K) };
+        static_assert(value.has_value(), "C(N, K) does not fit in T");
+        return *value;
+    }
+
+    template <typename T, std::uint64_t N, std::uint64_t K>
+    constexpr T permutations()
+    {
+        constexpr std::optional<T> value { permutations<T>(N, K) };
+        static_assert(value.has_value(), "N! / (N - K)! does not fit in T");
+        return *value;
+    }
+
+    template <typename T, std::uint64_t... Counts>
+    constexpr T multinomial()
+    {
+        constexpr std::optional<T> value { multinomial<T>({ Counts... }) };
+        static_assert(value.has_value(), "the multinomial coefficient does not fit in T");
+        return *value;
+    }
+}
+
+#endif
@@ -0,0 +1,178 @@
+// Build with: clang++ -std=c++17 -O2 main.cpp -o combinatorics
+// Run with:   ./combinatorics                the limits and the card probabilities
+//             ./combinatorics --benchmark    computed vs looked-up binomials, 10M queries
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Combinatorics.h"
+
+namespace Combi = ConstexprCombinatorics;
+using Combi::uint128;
+
+// The limits of each type, found by the compiler
+static_assert(Combi::maxFactorial<std::uint64_t>() == 20);
+static_assert(Combi::maxFactorial<uint128>() == 34);
+static_assert(Combi::maxBinomialRow<std::uint64_t>() == 67);
+static_assert(Combi::maxBinomialRow<uint128>() == 131);
+
+static_assert(Combi::factorial<std::uint64_t, 0>() == 1);
+static_assert(Combi::factorial<std::uint64_t, 20>() == 2'432'902'008'176'640'000u);
+static_assert(Combi::factorial<uint128, 25>() / Combi::factorial<uint128, 24>() == 25);
+static_assert(!Combi::factorial(21).has_value());
+static_assert(Combi::factorial<uint128>(34).has_value() && !Combi::factorial<uint128>(35).has_value());
+
+static_assert(Combi::binomial<std::uint64_t, 52, 5>() == 2'598'960); // poker hands
+static_assert(Combi::binomial<std::uint64_t, 67, 33>() == 14'226'520'737'620'288'370u);
+static_assert(!Combi::binomial(68, 34).has_value());
+static_assert(Combi::binomial(68, 3) == 50'116); // past the table, small k
+static_assert(Combi::binomial(1'000'000, 2) == 499'999'500'000);
+static_assert(Combi::binomial(5, 7) == 0);
+
+static_assert(Combi::permutations<std::uint64_t, 52, 2>() == 52 * 51);
+static_assert(Combi::permutations(100, 3) == 100 * 99 * 98);
+static_assert(!Combi::permutations(100, 20).has_value());
+
+static_assert(Combi::multinomial<std::uint64_t, 4, 4, 4>() == 34'650); // 12! / (4! 4! 4!)
+static_assert(Combi::multinomial({ 2, 0, 3 }) == 10);
+static_assert(!Combi::multinomial<uint128>({ 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 }).has_value()); // orders of a deck by rank
+
+// Overflows fail to compile, like factorial<-3>():
+// Combi::factorial<std::uint64_t, 21>();      // error: static assertion failed: N! does not fit in T
+// Combi::binomial<std::uint64_t, 68, 34>();   // error: static assertion failed: C(N, K) does not fit in T
+
+// factorial<N>() of s09, without the overflow check
+template <int N>
+constexpr int factorial()
+{
+    static_assert(N >= 0, "Factorial is not defined for negative numbers.");
+    int prod { 1 };
+    for (int i { 2 }; i <= N; ++i)
+    {
+        prod *= i;
+    }
+    return prod;
+}
+
+static_assert(static_cast<std::uint64_t>(factorial<12>()) == Combi::factorial<std::uint64_t, 12>());
+
+std::string toString(uint128 value)
+{
+    std::string digits {};
+    do
+    {
+        digits.insert(digits.begin(), static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+    return digits;
+}
+
+// C(n, k) the slow way: the multiplicative formula, every step checked
+std::optional<uint128> referenceBinomial(std::uint64_t n, std::uint64_t k)
+{
+    if (k > n)
+        return 0;
+    uint128 result { 1 };
+    for (std::uint64_t i { 1 }; i <= k; ++i)
+    {
+        const std::optional<uint128> product { Combi::multiply(result, static_cast<uint128>(n - k + i)) };
+        if (!product)
+            return std::nullopt;
+        result = *product / i; // exact: result is C(n - k + i, i) now
+    }
+    return result;
+}
+
+void checkTables()
+{
+    for (std::uint64_t n { 0 }; n <= 140; ++n)
+    {
+        for (std::uint64_t k { 0 }; k <= n + 1; ++k)
+        {
+            const std::optional<uint128> wide { Combi::binomial<uint128>(n, k) };
+            const std::optional<std::uint64_t> narrow { Combi::binomial(n, k) };
+            const std::optional<uint128> expected { referenceBinomial(n, k) };
+            if (expected && wide)
+                assert(*wide == *expected);
+            // every C(n, k) is either right or reported as too big, never wrapped
+            assert(!narrow || (wide && *narrow == *wide));
+            if (n <= Combi::maxBinomialRow<uint128>())
+                assert(wide.has_value());
+        }
+    }
+}
+
+// Blackjack with a shoe of some decks: the chance that the first two cards are an ace and a ten-valued card
+double naturalProbability(std::uint64_t decks)
+{
+    const std::uint64_t aces { 4 * decks };
+    const std::uint64_t tens { 16 * decks };
+    return static_cast<double>(aces * tens) / static_cast<double>(*Combi::binomial(52 * decks, 2));
+}
+
+// The chance that a hand of cards from one deck holds exactly aceCount aces
+double acesProbability(std::uint64_t cards, std::uint64_t aceCount)
+{
+    const std::uint64_t hands { *Combi::binomial(52, cards) };
+    return static_cast<double>(*Combi::binomial(4, aceCount) * *Combi::binomial(48, cards - aceCount)) / static_cast<double>(hands);
+}
+
+void benchmark()
+{
+    using Clock = std::chrono::steady_clock;
+    using Ns = std::chrono::duration<double, std::nano>;
+
+    constexpr std::size_t queries { 10'000'000 };
+    std::mt19937 rng { 42 };
+    std::vector<std::uint64_t> ns(queries);
+    std::vector<std::uint64_t> ks(queries);
+    for (std::size_t i { 0 }; i < queries; ++i)
+    {
+        ns[i] = rng() % 61;
+        ks[i] = rng() % (ns[i] + 1);
+    }
+
+    auto start { Clock::now() };
+    std::uint64_t tableSum { 0 };
+    for (std::size_t i { 0 }; i < queries; ++i)
+        tableSum += *Combi::binomial(ns[i], ks[i]);
+    const Ns tableTime { Clock::now() - start };
+
+    start = Clock::now();
+    std::uint64_t loopSum { 0 };
+    for (std::size_t i { 0 }; i < queries; ++i)
+        loopSum += static_cast<std::uint64_t>(*referenceBinomial(ns[i], ks[i]));
+    const Ns loopTime { Clock::now() - start };
+
+    assert(tableSum == loopSum);
+    std::cout << "C(n, k) for n < 61: " << tableTime.count() / queries << " ns from the table, "
+              << loopTime.count() / queries << " ns with the multiplicative formula\n";
+}
+
+int main(int argc, char* argv[])
+{
+    checkTables();
+
+    if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+    {
+        benchmark();
+        return 0;
+    }
+
+    std::cout << "20! = " << *Combi::factorial(20) << ", 34! = " << toString(*Combi::factorial<uint128>(34)) << '\n';
+    std::cout << "21! does not fit in 64 bits: " << !Combi::factorial(21) << '\n';
+    std::cout << "C(131, 65) = " << toString(*Combi::binomial<uint128>(131, 65)) << '\n';
+
+    for (const std::uint64_t decks : { 1, 2, 6, 8 })
+        std::cout << "Natural blackjack with " << decks << " deck(s): " << naturalProbability(decks) * 100 << "%\n";
+    for (std::uint64_t aces { 0 }; aces <= 4; ++aces)
+        std::cout << "Exactly " << aces << " ace(s) in a 5-card hand: " << acesProbability(5, aces) * 100 << "%\n";
+
+    return 0;
+}
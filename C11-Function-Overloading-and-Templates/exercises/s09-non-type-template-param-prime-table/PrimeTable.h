@@ -0,0 +1,108 @@
+// Prime tables computed at compile time, in the same spirit as factorial<N>()
+//
+// N is a non-type template parameter (the exclusive upper bound of the table), so every table is
+// a constexpr bitset or std::array baked into the executable: nothing runs at startup, and
+// isPrime<N>(x) is a single bit test (or a constant, when x is known at compile time too).
+//
+// The price is paid at compile time: a 1e6 table takes a few seconds to build. It fits in GCC's
+// default limits, while Clang stops constant evaluation after 1'048'576 steps by default:
+// raise it with -fconstexpr-steps=100000000 for the big tables.
+
+#ifndef PRIMETABLE_H
+#define PRIMETABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ConstexprPrimes
+{
+    // Words needed to store one bit per odd number below N
+    template <std::size_t N>
+    constexpr std::size_t wordCount() { return (N / 2 + 63) / 64 + 1; }
+
+    // Odd-only bitset: bit i is set when 2 * i + 1 is prime.
+    // A plain C-style array rather than std::array: constant evaluation is much cheaper without
+    // a function call behind every subscript, and the sieve below does millions of them.
+    template <std::size_t N>
+    struct Bitset
+    {
+        std::uint64_t words[wordCount<N>()] {};
+    };
+
+    // Odd-only sieve of Eratosthenes
+    template <std::size_t N>
+    constexpr Bitset<N> sieve()
+    {
+        static_assert(N >= 2, "The prime table needs a bound of at least 2.");
+
+        Bitset<N> result {};
+        std::uint64_t* bits { result.words };
+        for (std::size_t w { 0 }; w < wordCount<N>(); ++w)
+            bits[w] = ~std::uint64_t{ 0 };
+        bits[0] &= ~std::uint64_t{ 1 }; // 1 is not prime
+
+        // work on bit indices directly: odd multiples of p are p bits apart
+        constexpr std::size_t end { N / 2 };
+        for (std::size_t p { 3 }; p * p < N; p += 2)
+        {
+            if (!((bits[p / 128] >> (p / 2 % 64)) & 1))
+                continue;
+            for (std::size_t i { p * p / 2 }; i < end; i += p)
+                bits[i / 64] &= ~(std::uint64_t{ 1 } << (i % 64));
+        }
+
+        // clear everything at or past N
+        for (std::size_t i { N / 2 }; i < wordCount<N>() * 64; ++i)
+            bits[i / 64] &= ~(std::uint64_t{ 1 } << (i % 64));
+
+        return result;
+    }
+
+    // The bitset lives in read-only data: one copy per N for the whole program
+    template <std::size_t N>
+    inline constexpr Bitset<N> primeBits { sieve<N>() };
+
+    template <std::size_t N>
+    constexpr bool isPrime(std::uint64_t x)
+    {
+        if (x == 2)
+            return N > 2;
+        return x < N && (x & 1) && ((primeBits<N>.words[x / 128] >> (x / 2 % 64)) & 1);
+    }
+
+    // Number of primes below N
+    template <std::size_t N>
+    constexpr std::size_t primeCount()
+    {
+        std::size_t count { N > 2 ? 1u : 0u }; // 2 is not in the odd-only table
+        for (const std::uint64_t word : primeBits<N>.words)
+            count += static_cast<std::size_t>(__builtin_popcountll(word));
+        return count;
+    }
+
+    // Every prime below N, in increasing order
+    template <std::size_t N>
+    constexpr std::array<std::uint32_t, primeCount<N>()> makePrimes()
+    {
+        std::array<std::uint32_t, primeCount<N>()> result {};
+        std::size_t count { 0 };
+        if (N > 2)
+            result[count++] = 2;
+        for (std::size_t w { 0 }; w < wordCount<N>(); ++w)
+        {
+            std::uint64_t word { primeBits<N>.words[w] };
+            while (word)
+            {
+                result[count++] = static_cast<std::uint32_t>(2 * (w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))) + 1);
+                word &= word - 1;
+            }
+        }
+        return result;
+    }
+
+    template <std::size_t N>
+    inline constexpr std::array<std::uint32_t, primeCount<N>()> primes { makePrimes<N>() };
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Build with: clang++ -std=c++17 -O2 -fconstexpr-steps=100000000 main.cpp -o primes
+// (g++ needs no extra flag)
+
+#include <cstdint>
+#include <iostream>
+#include "PrimeTable.h"
+
+// Tables used in this program: every value below is computed by the compiler
+constexpr std::size_t smallBound { 100 };
+constexpr std::size_t bigBound { 1'000'000 };
+
+static_assert(ConstexprPrimes::primeCount<smallBound>() == 25);
+static_assert(ConstexprPrimes::primes<smallBound>[0] == 2);
+static_assert(ConstexprPrimes::primes<smallBound>[24] == 97);
+static_assert(ConstexprPrimes::primeCount<2>() == 0);
+static_assert(ConstexprPrimes::primeCount<3>() == 1);
+static_assert(ConstexprPrimes::primeCount<11>() == 4); // 11 itself is excluded
+static_assert(ConstexprPrimes::primeCount<bigBound>() == 78'498);
+static_assert(ConstexprPrimes::primes<bigBound>[78'497] == 999'983);
+
+static_assert(!ConstexprPrimes::isPrime<smallBound>(0));
+static_assert(!ConstexprPrimes::isPrime<smallBound>(1));
+static_assert(ConstexprPrimes::isPrime<smallBound>(2));
+static_assert(ConstexprPrimes::isPrime<smallBound>(97));
+static_assert(!ConstexprPrimes::isPrime<smallBound>(99));
+static_assert(!ConstexprPrimes::isPrime<smallBound>(101)); // past the bound
+static_assert(ConstexprPrimes::isPrime<bigBound>(13417));
+
+// Same idea as factorial<N>(): the argument is a template parameter, so the answer is a constant
+template <std::size_t X>
+constexpr bool isPrime()
+{
+    static_assert(X < bigBound, "isPrime<X>() only knows about numbers below bigBound.");
+    return ConstexprPrimes::isPrime<bigBound>(X);
+}
+
+int main()
+{
+    static_assert(isPrime<13417>());
+    static_assert(!isPrime<13419>());
+
+    // At runtime the lookup is a shift and a mask on a table stored in the executable
+    std::uint64_t x {};
+    std::cout << "Enter a number below " << bigBound << ": ";
+    std::cin >> x;
+    std::cout << x << (ConstexprPrimes::isPrime<bigBound>(x) ? " is" : " is not") << " prime\n";
+
+    std::cout << "There are " << ConstexprPrimes::primes<bigBound>.size() << " primes below " << bigBound
+              << ", the largest one is " << ConstexprPrimes::primes<bigBound>.back() << '\n';
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Header-only k-d tree over Point2d / Point3d (any type with dimensions, coord() and distanceSquaredTo())
+//
+// The tree is implicit: the points are reordered in a single std::vector so that every subtree is a
+// contiguous range [begin, end) whose splitting point sits in the middle. No nodes, no pointers,
+// and the whole thing is built in one go with std::nth_element (O(n log n)).
+// Every query works on squared distances, so there is no pow() and no sqrt() in the hot loops.
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <queue>
+#include <utility>
+#include <vector>
+
+template <typename Point>
+class KdTree
+{
+private:
+    static constexpr int dims { Point::dimensions };
+
+    // Ranges smaller than this are not split any further and are scanned linearly
+    static constexpr std::size_t leafSize { 8 };
+
+    std::vector<Point> m_points {};
+
+    void build(std::size_t begin, std::size_t end, int axis)
+    {
+        if (end - begin <= leafSize)
+            return;
+
+        const std::size_t mid { begin + (end - begin) / 2 };
+        std::nth_element(m_points.begin() + begin, m_points.begin() + mid, m_points.begin() + end,
+            [axis](const Point& a, const Point& b) { return a.coord(axis) < b.coord(axis); });
+
+        const int next { (axis + 1) % dims };
+        build(begin, mid, next);
+        build(mid + 1, end, next);
+    }
+
+    // (squared distance, index) pairs, the worst of the current k candidates on top
+    using Candidate = std::pair<double, std::size_t>;
+    using CandidateHeap = std::priority_queue<Candidate>;
+
+    void nearest(const Point& query, std::size_t k, std::size_t begin, std::size_t end, int axis, CandidateHeap& heap) const
+    {
+        if (end - begin <= leafSize)
+        {
+            for (std::size_t i { begin }; i < end; ++i)
+                offer(query, k, i, heap);
+            return;
+        }
+
+        const std::size_t mid { begin + (end - begin) / 2 };
+        offer(query, k, mid, heap);
+
+        const double delta { query.coord(axis) - m_points[mid].coord(axis) };
+        const int next { (axis + 1) % dims };
+
+        // Visit the side containing the query first, then the other one only if it can still hold a better point
+        if (delta < 0.0)
+            nearest(query, k, begin, mid, next, heap);
+        else
+            nearest(query, k, mid + 1, end, next, heap);
+
+        if (heap.size() < k || delta * delta < heap.top().first)
+        {
+            if (delta < 0.0)
+                nearest(query, k, mid + 1, end, next, heap);
+            else
+                nearest(query, k, begin, mid, next, heap);
+        }
+    }
+
+    void offer(const Point& query, std::size_t k, std::size_t index, CandidateHeap& heap) const
+    {
+        const double d2 { query.distanceSquaredTo(m_points[index]) };
+        if (heap.size() < k)
+            heap.emplace(d2, index);
+        else if (d2 < heap.top().first)
+        {
+            heap.pop();
+            heap.emplace(d2, index);
+        }
+    }
+
+    void within(const Point& query, double radius2, std::size_t begin, std::size_t end, int axis, std::vector<Point>& out) const
+    {
+        if (end - begin <= leafSize)
+        {
+            for (std::size_t i { begin }; i < end; ++i)
+                if (query.distanceSquaredTo(m_points[i]) <= radius2)
+                    out.push_back(m_points[i]);
+            return;
+        }
+
+        const std::size_t mid { begin + (end - begin) / 2 };
+        if (query.distanceSquaredTo(m_points[mid]) <= radius2)
+            out.push_back(m_points[mid]);
+
+        const double delta { query.coord(axis) - m_points[mid].coord(axis) };
+        const int next { (axis + 1) % dims };
+
+        if (delta <= 0.0 || delta * delta <= radius2)
+            within(query, radius2, begin, mid, next, out);
+        if (delta >= 0.0 || delta * delta <= radius2)
+            within(query, radius2, mid + 1, end, next, out);
+    }
+
+public:
+    KdTree() = default;
+
+    // Bulk construction: takes the points by value so callers can move a big vector in
+    explicit KdTree(std::vector<Point> points)
+    : m_points { std::move(points) }
+    {
+        build(0, m_points.size(), 0);
+    }
+
+    std::size_t size() const { return m_points.size(); }
+
+    // Returns the k points closest to query, closest first
+    std::vector<Point> kNearest(const Point& query, std::size_t k) const
+    {
+        std::vector<Point> result {};
+        if (k == 0 || m_points.empty())
+            return result;
+
+        CandidateHeap heap {};
+        nearest(query, k, 0, m_points.size(), 0, heap);
+
+        result.resize(heap.size());
+        for (std::size_t i { heap.size() }; i > 0; --i)
+        {
+            result[i - 1] = m_points[heap.top().second];
+            heap.pop();
+        }
+        return result;
+    }
+
+    // Returns every point whose distance from query is <= radius (in no particular order)
+    std::vector<Point> radiusSearch(const Point& query, double radius) const
+    {
+        std::vector<Point> result {};
+        if (radius >= 0.0)
+            within(query, radius * radius, 0, m_points.size(), 0, result);
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+// Point2d from question1b, plus a Point3d counterpart
+// Both expose their coordinates by axis, so the same KdTree template can index either of them
+
+#ifndef POINT_H
+#define POINT_H
+
+#include <cmath>
+#include <iostream>
+
+class Point2d
+{
+private:
+    double m_x { 0.0 };
+    double m_y { 0.0 };
+
+public:
+    static constexpr int dimensions { 2 };
+
+    Point2d() = default;
+
+    Point2d(double x, double y)
+    : m_x {x}
+    , m_y {y}
+    {}
+
+    double coord(int axis) const { return axis == 0 ? m_x : m_y; }
+
+    // Same implementation as question1b (kept as the brute-force reference)
+    double distanceTo(const Point2d& point) const
+    {
+        return std::sqrt(
+            std::pow(m_x - point.m_x, 2) +
+            std::pow(m_y - point.m_y, 2)
+        );
+    }
+
+    // No pow and no sqrt: enough for comparing distances
+    double distanceSquaredTo(const Point2d& point) const
+    {
+        const double dx { m_x - point.m_x };
+        const double dy { m_y - point.m_y };
+        return dx * dx + dy * dy;
+    }
+
+    void print() const
+    {
+        std::cout << "Point2d(" << m_x << ", " << m_y << ")\n";
+    }
+};
+
+class Point3d
+{
+private:
+    double m_x { 0.0 };
+    double m_y { 0.0 };
+    double m_z { 0.0 };
+
+public:
+    static constexpr int dimensions { 3 };
+
+    Point3d() = default;
+
+    Point3d(double x, double y, double z)
+    : m_x {x}
+    , m_y {y}
+    , m_z {z}
+    {}
+
+    double coord(int axis) const { return axis == 0 ? m_x : (axis == 1 ? m_y : m_z); }
+
+    double distanceTo(const Point3d& point) const
+    {
+        return std::sqrt(
+            std::pow(m_x - point.m_x, 2) +
+            std::pow(m_y - point.m_y, 2) +
+            std::pow(m_z - point.m_z, 2)
+        );
+    }
+
+    double distanceSquaredTo(const Point3d& point) const
+    {
+        const double dx { m_x - point.m_x };
+        const double dy { m_y - point.m_y };
+        const double dz { m_z - point.m_z };
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    void print() const
+    {
+        std::cout << "Point3d(" << m_x << ", " << m_y << ", " << m_z << ")\n";
+    }
+};
+
+#endif
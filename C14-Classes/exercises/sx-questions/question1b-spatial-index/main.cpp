@@ -0,0 +1,132 @@
+// k-NN and radius queries over many points: brute-force distanceTo() loops vs KdTree
+// Build with: clang++ -std=c++17 -O2 main.cpp -o spatial
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "KdTree.h"
+#include "Point.h"
+#include "Random.h"
+
+namespace Settings
+{
+    constexpr std::size_t points { 1'000'000 };
+    constexpr std::size_t queries { 100 };
+    constexpr std::size_t k { 5 };
+    constexpr double side { 1000.0 };
+    constexpr double radius { 2.0 };
+}
+
+double randomCoord()
+{
+    return std::uniform_real_distribution<double>{ 0.0, Settings::side }(Random::mt);
+}
+
+Point2d randomPoint2d() { return Point2d{ randomCoord(), randomCoord() }; }
+Point3d randomPoint3d() { return Point3d{ randomCoord(), randomCoord(), randomCoord() }; }
+
+// The way we would answer a nearest-neighbour query with question1b only
+template <typename Point>
+double bruteForceNearest(const std::vector<Point>& points, const Point& query)
+{
+    double best { query.distanceTo(points[0]) };
+    for (const auto& p : points)
+    {
+        const double d { query.distanceTo(p) };
+        if (d < best)
+            best = d;
+    }
+    return best;
+}
+
+template <typename Point>
+std::size_t bruteForceRadiusCount(const std::vector<Point>& points, const Point& query, double radius)
+{
+    std::size_t count { 0 };
+    for (const auto& p : points)
+        if (query.distanceTo(p) <= radius)
+            ++count;
+    return count;
+}
+
+template <typename Point>
+void benchmark(const char* name, Point (*makePoint)())
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    std::vector<Point> points {};
+    points.reserve(Settings::points);
+    for (std::size_t i { 0 }; i < Settings::points; ++i)
+        points.push_back(makePoint());
+
+    std::vector<Point> queries {};
+    for (std::size_t i { 0 }; i < Settings::queries; ++i)
+        queries.push_back(makePoint());
+
+    auto start { Clock::now() };
+    const KdTree<Point> tree { points };
+    const Ms buildTime { Clock::now() - start };
+
+    // brute force
+    std::vector<double> bruteNearest {};
+    std::vector<std::size_t> bruteRadius {};
+    start = Clock::now();
+    for (const auto& q : queries)
+    {
+        bruteNearest.push_back(bruteForceNearest(points, q));
+        bruteRadius.push_back(bruteForceRadiusCount(points, q, Settings::radius));
+    }
+    const Ms bruteTime { Clock::now() - start };
+
+    // k-d tree
+    std::vector<std::vector<Point>> treeNearest {};
+    std::vector<std::size_t> treeRadius {};
+    start = Clock::now();
+    for (const auto& q : queries)
+    {
+        treeNearest.push_back(tree.kNearest(q, Settings::k));
+        treeRadius.push_back(tree.radiusSearch(q, Settings::radius).size());
+    }
+    const Ms treeTime { Clock::now() - start };
+
+    // both approaches must agree
+    for (std::size_t i { 0 }; i < queries.size(); ++i)
+    {
+        assert(treeNearest[i].size() == Settings::k);
+        assert(queries[i].distanceTo(treeNearest[i][0]) == bruteNearest[i]);
+        for (std::size_t j { 1 }; j < Settings::k; ++j)
+            assert(queries[i].distanceSquaredTo(treeNearest[i][j - 1]) <= queries[i].distanceSquaredTo(treeNearest[i][j]));
+        assert(treeRadius[i] == bruteRadius[i]);
+    }
+
+    std::cout << name << ": " << Settings::points << " points, " << Settings::queries << " queries (1-NN + radius)\n"
+              << "  build:       " << buildTime.count() << " ms\n"
+              << "  brute force: " << bruteTime.count() << " ms\n"
+              << "  k-d tree:    " << treeTime.count() << " ms (" << Settings::k << "-NN + radius)\n"
+              << "  speedup:     " << bruteTime.count() / treeTime.count() << "x\n";
+}
+
+int main()
+{
+    Point2d first{};
+    Point2d second{ 3.0, 4.0 };
+    std::cout << "Distance between two points: " << first.distanceTo(second) << '\n';
+    assert(first.distanceSquaredTo(second) == 25.0);
+
+    // small hand-checked example
+    const KdTree<Point2d> small { std::vector<Point2d>{ {0, 0}, {1, 0}, {5, 5}, {2, 2}, {9, 9}, {0, 1}, {-3, 4}, {6, 6}, {7, 1}, {1, 1} } };
+    const auto closest { small.kNearest(Point2d{ 0.1, 0.1 }, 3) };
+    assert(closest.size() == 3);
+    assert(closest[0].distanceSquaredTo(Point2d{ 0, 0 }) == 0.0);
+    assert(small.radiusSearch(Point2d{ 0, 0 }, 1.5).size() == 4); // (0,0) (1,0) (0,1) (1,1)
+    assert(small.kNearest(Point2d{}, 100).size() == small.size());
+
+    benchmark<Point2d>("Point2d", randomPoint2d);
+    benchmark<Point3d>("Point3d", randomPoint3d);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Input/output for Fraction, kept out of the class so Fraction.h stays free of <iostream>
+// and every Fraction member can be constexpr
+
+#ifndef FRACTIONIO_H
+#define FRACTIONIO_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include "Fraction.h"
+
+// Prints the fraction in lowest terms
+inline std::ostream& operator<<(std::ostream& out, const Fraction& f)
+{
+    const Fraction r { f.normalized() };
+    out << r.numerator() << '/' << r.denominator();
+    return out;
+}
+
+inline void printFraction(const Fraction& f)
+{
+    std::cout << f << '\n';
+}
+
+// Asks until the input is an integer; exits if the input is closed
+inline std::int64_t getInt64(const char* prompt)
+{
+    while (true)
+    {
+        std::cout << prompt;
+        std::int64_t value {};
+        std::cin >> value;
+
+        if (std::cin)
+            return value;
+
+        if (std::cin.eof())
+            std::exit(0);
+
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Invalid input. Please enter an integer value.\n";
+    }
+}
+
+inline Fraction getFraction()
+{
+    const std::int64_t numerator { getInt64("Enter a value for numerator: ") };
+    std::int64_t denominator { getInt64("Enter a value for denominator: ") };
+    while (denominator == 0)
+    {
+        std::cout << "The denominator can't be 0.\n";
+        denominator = getInt64("Enter a value for denominator: ");
+    }
+    std::cout << '\n';
+    return Fraction { numerator, denominator };
+}
+
+#endif
@@ -0,0 +1,52 @@
+// Rational constants computed entirely at compile time
+// Every value here is a constexpr Fraction, so using them at runtime costs nothing more than a literal.
+
+#ifndef RATIONALCONSTANTS_H
+#define RATIONALCONSTANTS_H
+
+#include <array>
+#include <cstddef>
+#include "Fraction.h"
+
+namespace Units
+{
+    // Exact by definition (international yard and pound, 1959)
+    constexpr Fraction inchToCentimetre { 254, 100 };
+    constexpr Fraction footToInch { 12 };
+    constexpr Fraction mileToFoot { 5280 };
+    constexpr Fraction poundToKilogram { 45'359'237, 100'000'000 };
+    constexpr Fraction poundToOunce { 16 };
+
+    // Derived from the ones above by the compiler
+    constexpr Fraction footToMetre { (footToInch * inchToCentimetre / Fraction{ 100 }).normalized() };
+    constexpr Fraction mileToKilometre { (mileToFoot * footToMetre / Fraction{ 1000 }).normalized() };
+    constexpr Fraction ounceToGram { (poundToKilogram * Fraction{ 1000 } / poundToOunce).normalized() };
+    constexpr Fraction fahrenheitDegreeToKelvin { 5, 9 };
+
+    // value * factor, where factor.toDouble() is folded when factor is a constant
+    constexpr double convert(double value, const Fraction& factor)
+    {
+        return value * factor.toDouble();
+    }
+}
+
+namespace RationalTables
+{
+    // table[k] = 1 + 1/2 + ... + 1/(k+1)
+    template <std::size_t N>
+    constexpr std::array<Fraction, N> makeHarmonicNumbers()
+    {
+        std::array<Fraction, N> table {};
+        Fraction sum { 0 };
+        for (std::size_t k { 0 }; k < N; ++k)
+        {
+            sum += Fraction{ 1, static_cast<std::int64_t>(k + 1) };
+            table[k] = sum.normalized();
+        }
+        return table;
+    }
+
+    constexpr auto harmonic { makeHarmonicNumbers<30>() };
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Long chains of rational math with the Fraction class in Fraction.h
+// Build with: clang++ -std=c++17 -O2 main.cpp -o rational
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "Fraction.h"
+#include "FractionIO.h"
+#include "RationalConstants.h"
+
+// Everything below is checked by the compiler: no rational math is left for runtime
+static_assert(Fraction(1, 2) + Fraction(1, 3) == Fraction(5, 6));
+static_assert(Fraction(2, -4).numerator() == -1 && Fraction(2, -4).denominator() == 2);
+static_assert(Fraction(3, 4) / Fraction(3, 8) == Fraction(2));
+static_assert(Fraction(1, 3) < Fraction(1, 2));
+static_assert(Units::footToMetre.numerator() == 381 && Units::footToMetre.denominator() == 1250);
+static_assert(Units::mileToKilometre == Fraction(1'609'344, 1'000'000));
+static_assert(Units::ounceToGram == Fraction(28'349'523'125, 1'000'000'000));
+static_assert(Units::convert(1.0, Units::footToMetre) == 0.3048);
+static_assert(RationalTables::harmonic[0] == Fraction(1));
+static_assert(RationalTables::harmonic[3] == Fraction(25, 12));
+static_assert(RationalTables::harmonic[19] == Fraction(55'835'135, 15'519'504));
+
+void testOperators()
+{
+    const Fraction half { 1, 2 };
+    const Fraction third { 1, 3 };
+
+    assert(half + third == Fraction(5, 6));
+    assert(half - third == Fraction(1, 6));
+    assert(half * third == Fraction(1, 6));
+    assert(half / third == Fraction(3, 2));
+    assert(-half == Fraction(-1, 2));
+    assert(Fraction(2, -4) == Fraction(-1, 2));
+    assert(Fraction(2, -4).denominator() == 2);
+    assert(third < half && half > third && half >= half && third <= half && half != third);
+    assert(Fraction(6, 8).numerator() == 3 && Fraction(6, 8).denominator() == 4);
+
+    Fraction f { 3, 4 };
+    f *= Fraction { 4, 3 };
+    assert(f == Fraction(1));
+    f += Fraction { 1, 2 };
+    f -= Fraction { 1, 4 };
+    f /= Fraction { 5, 4 };
+    assert(f == Fraction(1));
+
+    bool threw { false };
+    try
+    {
+        Fraction bad { 1, 0 };
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try
+    {
+        Fraction huge { INT64_MAX, 1 };
+        huge = huge * Fraction { 3, 1 };
+    }
+    catch (const std::overflow_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    // the partial sum 2 * INT64_MAX does not fit in a Fraction, but the fold keeps it in 128 bits
+    const std::vector<Fraction> big { Fraction{ INT64_MAX }, Fraction{ INT64_MAX }, Fraction{ -INT64_MAX } };
+    assert(Fraction::sum(big.begin(), big.end()) == Fraction(INT64_MAX));
+    assert(Fraction::product(big.begin(), big.begin()) == Fraction(1));
+    assert(Fraction::sum(big.begin(), big.begin()) == Fraction(0));
+}
+
+int main()
+{
+    testOperators();
+
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    // 1/2 * 2/3 * 3/4 * ... * n/(n+1) = 1/(n+1)
+    // With int and no reduction (the original multiply()) this overflows after 12 terms
+    constexpr std::int64_t n { 1'000'000 };
+    std::vector<Fraction> telescoping {};
+    for (std::int64_t k { 1 }; k <= n; ++k)
+        telescoping.emplace_back(k, k + 1);
+
+    auto start { Clock::now() };
+    Fraction chained { 1 };
+    for (const auto& f : telescoping)
+        chained *= f;
+    const Ms chainTime { Clock::now() - start };
+
+    start = Clock::now();
+    const Fraction folded { Fraction::product(telescoping.begin(), telescoping.end()) };
+    const Ms foldTime { Clock::now() - start };
+
+    assert(chained == Fraction(1, n + 1));
+    assert(folded.numerator() == 1 && folded.denominator() == n + 1);
+    std::cout << "product of k/(k+1), k = 1.." << n << ": " << folded << '\n'
+              << "  operator*= chain: " << chainTime.count() << " ms\n"
+              << "  Fraction::product: " << foldTime.count() << " ms\n";
+
+    // 1/(1*2) + 1/(2*3) + ... + 1/(n*(n+1)) = n/(n+1)
+    std::vector<Fraction> series {};
+    for (std::int64_t k { 1 }; k <= n; ++k)
+        series.emplace_back(1, k * (k + 1));
+    const Fraction total { Fraction::sum(series.begin(), series.end()) };
+    assert(total == Fraction(n, n + 1));
+    std::cout << "sum of 1/(k(k+1)), k = 1.." << n << ": " << total << '\n';
+
+    // Harmonic number H(40): the denominator is lcm(1..40), far beyond int
+    std::vector<Fraction> harmonic {};
+    for (std::int64_t k { 1 }; k <= 40; ++k)
+        harmonic.emplace_back(1, k);
+    const Fraction h40 { Fraction::sum(harmonic.begin(), harmonic.end()) };
+    std::cout << "H(40) = " << h40 << " ~ " << h40.toDouble() << '\n';
+
+    std::cout << "H(30) from the compile-time table = " << RationalTables::harmonic[29] << '\n';
+    std::cout << "26.2 miles = " << Units::convert(26.2, Units::mileToKilometre) << " km"
+              << " (1 mile = " << Units::mileToKilometre << " km)\n";
+
+    Fraction f1 { getFraction() };
+    Fraction f2 { getFraction() };
+
+    std::cout << "Your fractions multiplied together: ";
+    printFraction(f1.multiply(f2));
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Member functions of the PointCloud3d class defined here
+
+#include "PointCloud3d.h"
+
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Batch kernels working on one coordinate array at a time.
+    // The AVX2 versions handle 4 doubles per iteration and finish the tail with the scalar loop.
+
+    void addScalar(double* values, std::size_t count, double delta)
+    {
+        std::size_t i { 0 };
+#if defined(__AVX2__)
+        const __m256d d { _mm256_set1_pd(delta) };
+        for (; i + 4 <= count; i += 4)
+            _mm256_storeu_pd(values + i, _mm256_add_pd(_mm256_loadu_pd(values + i), d));
+#endif
+        for (; i < count; ++i)
+            values[i] += delta;
+    }
+
+    void mulScalar(double* values, std::size_t count, double factor)
+    {
+        std::size_t i { 0 };
+#if defined(__AVX2__)
+        const __m256d f { _mm256_set1_pd(factor) };
+        for (; i + 4 <= count; i += 4)
+            _mm256_storeu_pd(values + i, _mm256_mul_pd(_mm256_loadu_pd(values + i), f));
+#endif
+        for (; i < count; ++i)
+            values[i] *= factor;
+    }
+
+    void distances(const double* x, const double* y, const double* z, std::size_t count,
+                   double px, double py, double pz, double* out)
+    {
+        std::size_t i { 0 };
+#if defined(__AVX2__)
+        const __m256d vx { _mm256_set1_pd(px) };
+        const __m256d vy { _mm256_set1_pd(py) };
+        const __m256d vz { _mm256_set1_pd(pz) };
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m256d dx { _mm256_sub_pd(_mm256_loadu_pd(x + i), vx) };
+            const __m256d dy { _mm256_sub_pd(_mm256_loadu_pd(y + i), vy) };
+            const __m256d dz { _mm256_sub_pd(_mm256_loadu_pd(z + i), vz) };
+            const __m256d sum { _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz)) };
+            _mm256_storeu_pd(out + i, _mm256_sqrt_pd(sum));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const double dx { x[i] - px };
+            const double dy { y[i] - py };
+            const double dz { z[i] - pz };
+            out[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+}
+
+PointCloud3d::PointCloud3d(const std::vector<Point3d>& points)
+{
+    reserve(points.size());
+    for (const auto& p : points)
+        push_back(p);
+}
+
+void PointCloud3d::reserve(std::size_t count)
+{
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_z.reserve(count);
+}
+
+void PointCloud3d::push_back(const Point3d& point)
+{
+    m_x.push_back(point.m_x);
+    m_y.push_back(point.m_y);
+    m_z.push_back(point.m_z);
+}
+
+Point3d PointCloud3d::operator[](std::size_t index) const
+{
+    return Point3d { m_x[index], m_y[index], m_z[index] };
+}
+
+void PointCloud3d::translate(const Vector3d& v)
+{
+    addScalar(m_x.data(), m_x.size(), v.m_x);
+    addScalar(m_y.data(), m_y.size(), v.m_y);
+    addScalar(m_z.data(), m_z.size(), v.m_z);
+}
+
+void PointCloud3d::scale(double factor)
+{
+    mulScalar(m_x.data(), m_x.size(), factor);
+    mulScalar(m_y.data(), m_y.size(), factor);
+    mulScalar(m_z.data(), m_z.size(), factor);
+}
+
+void PointCloud3d::distancesTo(const Point3d& p, std::vector<double>& out) const
+{
+    out.resize(size());
+    distances(m_x.data(), m_y.data(), m_z.data(), size(), p.m_x, p.m_y, p.m_z, out.data());
+}
+
+const char* PointCloud3d::backend()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#else
+    return "portable";
+#endif
+}
@@ -0,0 +1,52 @@
+// Header file that defines the PointCloud3d class
+//
+// Point3d stores x, y and z next to each other (array of structs) and moves one point per call.
+// PointCloud3d stores every coordinate in its own contiguous array (structure of arrays), so batch
+// operations become straight loops over plain doubles: 4 points per instruction with AVX2
+// (compile with -mavx2 or -march=native), or a portable scalar loop the compiler can still vectorize.
+
+#ifndef POINTCLOUD3D_H
+#define POINTCLOUD3D_H
+
+#include <cstddef>
+#include <vector>
+#include "Point3d.h"
+#include "Vector3d.h"
+
+class PointCloud3d
+{
+private:
+    std::vector<double> m_x {};
+    std::vector<double> m_y {};
+    std::vector<double> m_z {};
+
+public:
+    PointCloud3d() = default;
+    explicit PointCloud3d(const std::vector<Point3d>& points);
+
+    void reserve(std::size_t count);
+    void push_back(const Point3d& point);
+
+    std::size_t size() const { return m_x.size(); }
+
+    double x(std::size_t index) const { return m_x[index]; }
+    double y(std::size_t index) const { return m_y[index]; }
+    double z(std::size_t index) const { return m_z[index]; }
+
+    // Rebuilds the point at index as a regular Point3d
+    Point3d operator[](std::size_t index) const;
+
+    // Same as calling moveByVector(v) on every point
+    void translate(const Vector3d& v);
+
+    // Multiplies every coordinate by factor (scaling around the origin)
+    void scale(double factor);
+
+    // out[i] = distance between point i and p. out is resized to size()
+    void distancesTo(const Point3d& p, std::vector<double>& out) const;
+
+    // Name of the kernel implementation selected at compile time
+    static const char* backend();
+};
+
+#endif
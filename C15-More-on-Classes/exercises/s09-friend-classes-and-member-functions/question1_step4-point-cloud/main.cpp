@@ -0,0 +1,90 @@
+// Moving millions of points: Point3d::moveByVector() one point at a time vs PointCloud3d::translate()
+// Build with: clang++ -std=c++17 -O2 -mavx2 main.cpp Point3d.cpp Vector3d.cpp PointCloud3d.cpp -o cloud
+// (drop -mavx2 to get the portable kernels)
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "Point3d.h"
+#include "PointCloud3d.h"
+#include "Vector3d.h"
+
+namespace Settings
+{
+	constexpr std::size_t points { 10'000'000 };
+	constexpr int steps { 10 };
+}
+
+// true when both clouds hold the same points, coordinate by coordinate
+bool samePoints(const PointCloud3d& a, const PointCloud3d& b, double tolerance)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (std::size_t i { 0 }; i < a.size(); ++i)
+	{
+		if (std::abs(a.x(i) - b.x(i)) > tolerance || std::abs(a.y(i) - b.y(i)) > tolerance || std::abs(a.z(i) - b.z(i)) > tolerance)
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	Point3d p { 1.0, 2.0, 3.0 };
+	Vector3d v { 2.0, 2.0, -3.0 };
+
+	p.print();
+	p.moveByVector(v);
+	p.print();
+
+	// the batch kernels must match the single point version
+	std::vector<Point3d> points { { 1.0, 2.0, 3.0 }, { -1.0, 0.5, 4.0 }, { 0.0, 0.0, 0.0 }, { 3.0, 3.0, 3.0 }, { 7.0, -2.0, 1.0 } };
+	PointCloud3d small { points };
+	small.translate(v);
+	for (auto& point : points)
+		point.moveByVector(v);
+	assert(samePoints(small, PointCloud3d{ points }, 1e-12));
+	small.scale(2.0);
+	std::vector<double> dist {};
+	small.distancesTo(Point3d{ 0.0, 0.0, 0.0 }, dist);
+	assert(dist.size() == small.size());
+	assert(std::abs(dist[2] - std::sqrt(4.0 * 4.0 + 4.0 * 4.0 + 6.0 * 6.0)) < 1e-12); // (0,0,0) -> (2,2,-3) -> (4,4,-6)
+	assert(std::abs(dist[4] - std::sqrt(18.0 * 18.0 + 0.0 + 4.0 * 4.0)) < 1e-12);     // (7,-2,1) -> (9,0,-2) -> (18,0,-4)
+
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::duration<double, std::milli>;
+
+	std::vector<Point3d> particles {};
+	particles.reserve(Settings::points);
+	for (std::size_t i { 0 }; i < Settings::points; ++i)
+		particles.emplace_back(static_cast<double>(i), 0.5 * static_cast<double>(i), -1.0 * static_cast<double>(i));
+	PointCloud3d cloud { particles };
+
+	const Vector3d step { 0.1, -0.2, 0.3 };
+
+	auto start { Clock::now() };
+	for (int s { 0 }; s < Settings::steps; ++s)
+		for (auto& particle : particles)
+			particle.moveByVector(step);
+	const Ms aosTime { Clock::now() - start };
+
+	start = Clock::now();
+	for (int s { 0 }; s < Settings::steps; ++s)
+		cloud.translate(step);
+	const Ms soaTime { Clock::now() - start };
+
+	// both ways must have moved every point to the same place
+	assert(samePoints(cloud, PointCloud3d{ particles }, 1e-9));
+
+	// each step reads and writes 3 doubles per point
+	const double bytes { static_cast<double>(Settings::points) * Settings::steps * 3 * sizeof(double) * 2 };
+
+	std::cout << Settings::points << " points, " << Settings::steps << " steps (" << PointCloud3d::backend() << " kernels)\n"
+	          << "  Point3d::moveByVector:  " << aosTime.count() << " ms\n"
+	          << "  PointCloud3d::translate: " << soaTime.count() << " ms (" << bytes / (soaTime.count() * 1e6) << " GB/s)\n";
+
+	return 0;
+}
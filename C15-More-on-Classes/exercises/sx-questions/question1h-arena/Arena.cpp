@@ -0,0 +1,134 @@
+// Member functions of World and Scheduler defined here
+
+#include "Arena.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    // Base stats for every Monster::Type, indexed by the enumerator
+    //                                            dragon goblin ogre orc skeleton troll vampire zombie
+    constexpr std::array<int, Monster::maxMonsterTypes> baseAttack  { 30,    8,     18,  14,  10,      20,   22,     9 };
+    constexpr std::array<int, Monster::maxMonsterTypes> baseDefense { 12,    3,      8,   6,   4,       9,    7,     2 };
+}
+
+namespace Arena
+{
+    void World::reserve(std::size_t count)
+    {
+        m_type.reserve(count);
+        m_attack.reserve(count);
+        m_defense.reserve(count);
+        m_hp.reserve(count);
+    }
+
+    std::size_t World::add(Monster::Type type, int attack, int defense, int hp)
+    {
+        m_type.push_back(type);
+        m_attack.push_back(attack);
+        m_defense.push_back(defense);
+        m_hp.push_back(hp);
+        return m_hp.size() - 1;
+    }
+
+    std::size_t World::add(const Monster& monster)
+    {
+        const Monster::Type type { monster.getType() };
+        return add(type, baseAttack[type], baseDefense[type], monster.getPoints());
+    }
+
+    std::size_t World::countAlive() const
+    {
+        return static_cast<std::size_t>(std::count_if(m_hp.begin(), m_hp.end(), [](int hp) { return hp > 0; }));
+    }
+
+    void populate(World& world, std::size_t count)
+    {
+        world.reserve(world.size() + count);
+        for (std::size_t i { 0 }; i < count; ++i)
+            world.add(MonsterGenerator::generate());
+    }
+
+    Scheduler::Scheduler(World& world, unsigned threads)
+        : m_world { world }
+        , m_threads { threads ? threads : std::max(1u, std::thread::hardware_concurrency()) }
+    {
+    }
+
+    TickStats Scheduler::tick()
+    {
+        const auto start { std::chrono::steady_clock::now() };
+
+        World& w { m_world };
+        const std::size_t n { w.size() };
+        m_damage.resize(n);
+
+        TickStats stats {};
+        stats.tick = ++m_tick;
+
+        std::vector<std::size_t> fighters(m_threads);
+        std::vector<std::size_t> alive(m_threads);
+
+        if (n > 1)
+        {
+            // Entity j is attacked by entity (j - shift) mod n. Since this is a bijection every entity
+            // deals and receives exactly one attack, and each thread only writes to its own slice.
+            const std::size_t shift { 1 + (static_cast<std::size_t>(m_tick) * 2654435761u) % (n - 1) };
+
+            const int* hp { w.m_hp.data() };
+            const int* attack { w.m_attack.data() };
+            const int* defense { w.m_defense.data() };
+            int* damage { m_damage.data() };
+
+            // Phase 1: read-only pass over the components, damage goes in the scratch buffer
+            Parallel::forEachChunk(n, m_threads, [=](std::size_t begin, std::size_t end, unsigned)
+            {
+                for (std::size_t j { begin }; j < end; ++j)
+                {
+                    const std::size_t a { j >= shift ? j - shift : j + n - shift };
+                    const bool fight { hp[j] > 0 && hp[a] > 0 };
+                    const int hit { std::max(1, attack[a] - defense[j]) };
+                    damage[j] = fight ? hit : 0;
+                }
+            });
+
+            // Phase 2: apply the damage and count who is still standing
+            int* hpOut { w.m_hp.data() };
+            Parallel::forEachChunk(n, m_threads, [=, &fighters, &alive](std::size_t begin, std::size_t end, unsigned chunk)
+            {
+                std::size_t before { 0 };
+                std::size_t after { 0 };
+                for (std::size_t j { begin }; j < end; ++j)
+                {
+                    before += (hpOut[j] > 0);
+                    hpOut[j] -= damage[j];
+                    after += (hpOut[j] > 0);
+                }
+                fighters[chunk] = before;
+                alive[chunk] = after;
+            });
+        }
+        else
+        {
+            fighters[0] = alive[0] = w.countAlive();
+        }
+
+        for (unsigned chunk { 0 }; chunk < m_threads; ++chunk)
+        {
+            stats.fighters += fighters[chunk];
+            stats.alive += alive[chunk];
+        }
+
+        const std::chrono::duration<double> elapsed { std::chrono::steady_clock::now() - start };
+        stats.latencyMs = elapsed.count() * 1000.0;
+        stats.entitiesPerSecond = elapsed.count() > 0.0 ? static_cast<double>(n) / elapsed.count() : 0.0;
+
+        assert(stats.alive <= stats.fighters && "Scheduler::tick() brought a dead monster back to life");
+        return stats;
+    }
+}
@@ -0,0 +1,77 @@
+// Header file for the battle simulation built on top of Monster and MonsterGenerator
+// Monsters are split into components (type, attack, defense, hit points) and every
+// component lives in its own packed std::vector, indexed by the entity id (ECS style).
+// This way a combat round is just a few tight loops over contiguous arrays.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+#include "Monster.h"
+
+namespace Arena
+{
+    // Timing information collected for one call to Scheduler::tick()
+    struct TickStats
+    {
+        int tick {};
+        std::size_t fighters {};         // entities that were alive when the tick started
+        std::size_t alive {};            // entities still alive after the tick
+        double latencyMs {};
+        double entitiesPerSecond {};
+    };
+
+    class World
+    {
+    private:
+        // one packed array per component, the index is the entity id
+        std::vector<Monster::Type> m_type {};
+        std::vector<int> m_attack {};
+        std::vector<int> m_defense {};
+        std::vector<int> m_hp {};
+
+    public:
+        void reserve(std::size_t count);
+
+        // Adds the monster to the world and returns its entity id
+        std::size_t add(const Monster& monster);
+        std::size_t add(Monster::Type type, int attack, int defense, int hp);
+
+        std::size_t size() const { return m_hp.size(); }
+        std::size_t countAlive() const;
+
+        Monster::Type type(std::size_t id) const { return m_type[id]; }
+        int attack(std::size_t id) const { return m_attack[id]; }
+        int defense(std::size_t id) const { return m_defense[id]; }
+        int hp(std::size_t id) const { return m_hp[id]; }
+
+        // Scheduler needs raw access to the component arrays
+        friend class Scheduler;
+    };
+
+    // Fills the world with count monsters coming from MonsterGenerator::generate()
+    void populate(World& world, std::size_t count);
+
+    class Scheduler
+    {
+    private:
+        World& m_world;
+        unsigned m_threads {};
+        int m_tick {};
+        std::vector<int> m_damage {};    // scratch buffer: damage received by each entity this tick
+
+    public:
+        // threads == 0 means "use every hardware thread"
+        explicit Scheduler(World& world, unsigned threads = 0);
+
+        // Resolves one combat round: every entity attacks exactly one opponent.
+        // Damage is computed from the state at the start of the round, so the
+        // order in which entities are processed (and the number of threads) does not matter.
+        TickStats tick();
+
+        unsigned threads() const { return m_threads; }
+    };
+}
+
+#endif
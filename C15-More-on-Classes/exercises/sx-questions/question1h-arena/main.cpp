@@ -0,0 +1,66 @@
+// Battle arena built on top of question1h
+// Build with: clang++ -std=c++17 -O2 -pthread -I../../../../external/parallel main.cpp Arena.cpp -o arena
+
+#include <cassert>
+#include <iostream>
+#include "Arena.h"
+#include "Monster.h"
+
+namespace Settings
+{
+    constexpr std::size_t fighters { 1'000'000 };
+    constexpr int maxTicks { 20 };
+}
+
+// Two monsters with known stats, to check the combat rules by hand
+void testDuel()
+{
+    Arena::World world {};
+    world.add(Monster::dragon, 30, 12, 100);
+    world.add(Monster::goblin, 8, 3, 40);
+
+    Arena::Scheduler scheduler { world, 1 };
+    Arena::TickStats stats { scheduler.tick() };
+
+    assert(stats.fighters == 2);
+    assert(world.hp(0) == 100 - 1);         // goblin hits for max(1, 8 - 12)
+    assert(world.hp(1) == 40 - (30 - 3));   // dragon hits for 30 - 3
+
+    stats = scheduler.tick();
+    assert(world.hp(1) <= 0);
+    assert(stats.alive == 1);
+
+    // dead monsters neither deal nor receive damage
+    stats = scheduler.tick();
+    assert(world.hp(0) == 100 - 2);
+    assert(stats.fighters == 1 && stats.alive == 1);
+}
+
+int main()
+{
+    testDuel();
+
+    Monster m{ MonsterGenerator::generate() };
+    m.print();
+
+    Arena::World world {};
+    Arena::populate(world, Settings::fighters);
+
+    Arena::Scheduler scheduler { world };
+    std::cout << "Arena with " << world.size() << " monsters (" << world.countAlive() << " alive) on "
+              << scheduler.threads() << " thread(s)\n";
+
+    for (int i { 0 }; i < Settings::maxTicks; ++i)
+    {
+        const Arena::TickStats stats { scheduler.tick() };
+        std::cout << "tick " << stats.tick
+                  << ": " << stats.fighters << " -> " << stats.alive << " alive, "
+                  << stats.latencyMs << " ms, "
+                  << stats.entitiesPerSecond / 1e6 << " M entities/s\n";
+
+        if (stats.alive <= 1)
+            break;
+    }
+
+    return 0;
+}
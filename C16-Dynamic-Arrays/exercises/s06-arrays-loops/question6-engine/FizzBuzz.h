@@ -0,0 +1,400 @@
+// FizzBuzz for any divisors and words, fast enough to print up to 1e12 lines
+//
+// fizzbuzz() does one % per divisor for every number and sends every token through std::cout.
+// FizzBuzz::Engine instead:
+// * finds the words of a number without any division. Whether n is a multiple of d only depends
+//   on n mod lcm(divisors), so the words of every residue are computed once (the "wheel", 4849845
+//   entries for 3, 5, 7, ..., 19) and n simply walks along it. When the lcm is too large for a
+//   table, one countdown per divisor is used instead of %.
+// * keeps the current number as decimal text and increments that text in place, instead of
+//   converting every number from binary;
+// * formats into a large buffer, copying every line as one fixed-size block, and hands the buffer
+//   to write() in one call, bypassing iostreams.
+// The multithreaded writer formats consecutive chunks of numbers on every thread and writes the
+// chunks in order.
+
+#ifndef FIZZBUZZ_H
+#define FIZZBUZZ_H
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace FizzBuzz
+{
+	// write() all of data, retrying after partial writes and signals
+	inline void writeAll(int fd, const char* data, std::size_t size)
+	{
+		while (size > 0)
+		{
+			const ssize_t n { ::write(fd, data, size) };
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				throw std::system_error(errno, std::generic_category(), "write() failed");
+			}
+			data += n;
+			size -= static_cast<std::size_t>(n);
+		}
+	}
+
+	// Lines of the wheel are copied as fixed blocks of this many bytes: one or two vector moves
+	// instead of a memcpy() call of variable length
+	constexpr std::size_t lineBlock { 32 };
+
+	// A number as decimal text followed by '\n', that can be incremented without converting it again
+	class DecimalCounter
+	{
+	private:
+		// the digits are right-aligned before m_digits[end] = '\n'; the rest of the array lets
+		// line() be read as a whole lineBlock
+		static constexpr std::size_t end { 24 };
+
+		char m_digits[end + lineBlock] {};
+		std::size_t m_length {};
+
+	public:
+		explicit DecimalCounter(std::uint64_t value)
+		{
+			do
+			{
+				m_digits[end - ++m_length] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			} while (value != 0);
+			m_digits[end] = '\n';
+		}
+
+		void increment()
+		{
+			std::size_t i { end - 1 };
+			while (m_digits[i] == '9') // carry: 1999 -> 2000
+				m_digits[i--] = '0';
+			if (i < end - m_length) // 999 -> 1000
+			{
+				m_digits[i] = '1';
+				++m_length;
+			}
+			else
+				++m_digits[i];
+		}
+
+		const char* data() const { return m_digits + end - m_length; }
+		std::size_t size() const { return m_length; }
+
+		// the digits and '\n'; lineBlock bytes can be read from here
+		const char* line() const { return data(); }
+		std::size_t lineSize() const { return m_length + 1; }
+	};
+
+	class Engine
+	{
+	public:
+		enum class Mode
+		{
+			wheel,    // table of the words of every residue modulo the lcm of the divisors
+			counters, // one countdown per divisor
+		};
+
+		// Largest wheel we are willing to build (entries of 2 bytes)
+		static constexpr std::uint64_t wheelLimit { std::uint64_t{ 1 } << 24 };
+
+		// Numbers per chunk in write(): a few MB of text per thread
+		static constexpr std::uint64_t chunkNumbers { std::uint64_t{ 1 } << 18 };
+
+	private:
+		std::vector<std::uint64_t> m_divisors {};
+		std::vector<std::string> m_words {};
+		Mode m_mode {};
+		std::size_t m_maxLineLength {};
+
+		// wheel mode: m_wheel[n % m_period] is the index in m_texts of the words for n (0: the number itself)
+		std::uint64_t m_period {};
+		std::vector<std::uint16_t> m_wheel {};
+		std::vector<std::string> m_texts {};
+
+		// the same texts with their '\n', one lineBlock each, when they are short enough
+		std::vector<char> m_lines {};
+		std::vector<std::uint8_t> m_lineSizes {};
+
+		void buildWheel()
+		{
+			m_wheel.resize(static_cast<std::size_t>(m_period));
+			m_texts.assign(1, "");
+
+			// words for each set of divisors, as a bit mask, already seen
+			std::vector<std::uint16_t> textOfMask(std::size_t{ 1 } << m_divisors.size(), 0);
+			for (std::uint64_t r { 0 }; r < m_period; ++r)
+			{
+				std::size_t mask { 0 };
+				for (std::size_t j { 0 }; j < m_divisors.size(); ++j)
+					if (r % m_divisors[j] == 0)
+						mask |= std::size_t{ 1 } << j;
+
+				if (mask != 0 && textOfMask[mask] == 0)
+				{
+					std::string text {};
+					for (std::size_t j { 0 }; j < m_divisors.size(); ++j)
+						if (mask & (std::size_t{ 1 } << j))
+							text += m_words[j];
+					m_texts.push_back(text);
+					textOfMask[mask] = static_cast<std::uint16_t>(m_texts.size() - 1);
+				}
+				m_wheel[static_cast<std::size_t>(r)] = textOfMask[mask];
+			}
+
+			const bool fitsBlock { std::all_of(m_texts.begin(), m_texts.end(),
+				[](const std::string& text) { return text.size() < lineBlock; }) };
+			if (!fitsBlock)
+				return;
+			m_lines.assign(m_texts.size() * lineBlock, '\0');
+			m_lineSizes.resize(m_texts.size());
+			for (std::size_t i { 1 }; i < m_texts.size(); ++i)
+			{
+				std::memcpy(m_lines.data() + i * lineBlock, m_texts[i].data(), m_texts[i].size());
+				m_lines[i * lineBlock + m_texts[i].size()] = '\n';
+				m_lineSizes[i] = static_cast<std::uint8_t>(m_texts[i].size() + 1);
+			}
+		}
+
+		static char* append(char* out, const char* data, std::size_t size)
+		{
+			std::memcpy(out, data, size);
+			return out + size;
+		}
+
+		char* formatWheel(std::uint64_t first, std::uint64_t last, char* out) const
+		{
+			DecimalCounter number { first };
+			std::uint64_t r { first % m_period };
+
+			if (!m_lines.empty())
+			{
+				// no branch on "number or words": pick the source, copy a whole block, keep what is needed
+				for (std::uint64_t n { first }; n <= last; ++n)
+				{
+					const std::uint16_t text { m_wheel[static_cast<std::size_t>(r)] };
+					const char* line { text == 0 ? number.line() : m_lines.data() + text * lineBlock };
+					const std::size_t size { text == 0 ? number.lineSize() : m_lineSizes[text] };
+					std::memcpy(out, line, lineBlock);
+					out += size;
+
+					number.increment();
+					if (++r == m_period)
+						r = 0;
+				}
+				return out;
+			}
+
+			for (std::uint64_t n { first }; n <= last; ++n)
+			{
+				const std::uint16_t text { m_wheel[static_cast<std::size_t>(r)] };
+				if (text == 0)
+					out = append(out, number.data(), number.size());
+				else
+					out = append(out, m_texts[text].data(), m_texts[text].size());
+				*out++ = '\n';
+
+				number.increment();
+				if (++r == m_period)
+					r = 0;
+			}
+			return out;
+		}
+
+		char* formatCounters(std::uint64_t first, std::uint64_t last, char* out) const
+		{
+			DecimalCounter number { first };
+
+			// countdown[j]: numbers left until the next multiple of m_divisors[j]
+			std::vector<std::uint64_t> countdown(m_divisors.size());
+			for (std::size_t j { 0 }; j < m_divisors.size(); ++j)
+				countdown[j] = (m_divisors[j] - first % m_divisors[j]) % m_divisors[j];
+
+			for (std::uint64_t n { first }; n <= last; ++n)
+			{
+				bool printed { false };
+				for (std::size_t j { 0 }; j < m_divisors.size(); ++j)
+				{
+					if (countdown[j] == 0)
+					{
+						out = append(out, m_words[j].data(), m_words[j].size());
+						printed = true;
+						countdown[j] = m_divisors[j];
+					}
+					--countdown[j];
+				}
+				if (!printed)
+					out = append(out, number.data(), number.size());
+				*out++ = '\n';
+
+				number.increment();
+			}
+			return out;
+		}
+
+	public:
+		// The wheel is used when the lcm of the divisors is small enough
+		Engine(std::vector<std::uint64_t> divisors, std::vector<std::string> words)
+		: m_divisors { std::move(divisors) }
+		, m_words { std::move(words) }
+		{
+			if (m_divisors.size() != m_words.size())
+				throw std::invalid_argument("FizzBuzz::Engine: divisors and words sizes don't match");
+			if (std::find(m_divisors.begin(), m_divisors.end(), 0) != m_divisors.end())
+				throw std::invalid_argument("FizzBuzz::Engine: divisor 0");
+
+			m_period = 1;
+			for (const std::uint64_t d : m_divisors)
+			{
+				m_period = std::lcm(m_period, d);
+				if (m_period > wheelLimit)
+					break;
+			}
+			// 16 divisors at most, so a set of divisors fits in the mask table
+			m_mode = (m_period <= wheelLimit && m_divisors.size() <= 16) ? Mode::wheel : Mode::counters;
+			if (m_mode == Mode::wheel)
+				buildWheel();
+
+			std::size_t allWords { 0 };
+			for (const auto& word : m_words)
+				allWords += word.size();
+			m_maxLineLength = std::max<std::size_t>(allWords, 20) + 1; // 20 digits for any uint64
+		}
+
+		// The classic: 3, 5, 7, 11, 13, 17, 19 and their words
+		static Engine classic()
+		{
+			return Engine { { 3, 5, 7, 11, 13, 17, 19 }, { "fizz", "buzz", "pop", "bang", "jazz", "pow", "boom" } };
+		}
+
+		Mode mode() const { return m_mode; }
+
+		// Upper bound of the length of one line, newline included
+		std::size_t maxLineLength() const { return m_maxLineLength; }
+
+		// Room needed by format() for count lines: the last line may write a whole lineBlock
+		std::size_t bufferSize(std::uint64_t count) const
+		{
+			return static_cast<std::size_t>(count) * m_maxLineLength + lineBlock;
+		}
+
+		// Writes the lines for first..last (first >= 1) to out, which must have room for
+		// bufferSize(last - first + 1) characters. Returns the end of the text.
+		char* format(std::uint64_t first, std::uint64_t last, char* out) const
+		{
+			assert(first >= 1 && "FizzBuzz::Engine::format: numbers start at 1");
+			if (first > last)
+				return out;
+			return m_mode == Mode::wheel ? formatWheel(first, last, out) : formatCounters(first, last, out);
+		}
+
+		std::string toString(std::uint64_t first, std::uint64_t last) const
+		{
+			if (first > last)
+				return {};
+			std::string text(bufferSize(last - first + 1), '\0');
+			text.resize(static_cast<std::size_t>(format(first, last, text.data()) - text.data()));
+			return text;
+		}
+
+		// Writes the lines for 1..count to fd, threads == 0: every hardware thread
+		void write(int fd, std::uint64_t count, unsigned threads = 1) const
+		{
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			const std::uint64_t chunks { (count + chunkNumbers - 1) / chunkNumbers };
+			threads = static_cast<unsigned>(std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads, chunks)));
+
+			// Thread t formats chunks t, t + threads, ... and waits for its turn to write each one
+			std::mutex mutex {};
+			std::condition_variable turnChanged {};
+			std::uint64_t turn { 0 };
+			bool failed { false };
+
+			auto work = [&](unsigned t)
+			{
+				std::vector<char> buffer(bufferSize(chunkNumbers));
+				for (std::uint64_t chunk { t }; chunk < chunks; chunk += threads)
+				{
+					const std::uint64_t first { chunk * chunkNumbers + 1 };
+					const std::uint64_t last { std::min(count, first + chunkNumbers - 1) };
+					const char* end { format(first, last, buffer.data()) };
+
+					std::unique_lock lock { mutex };
+					turnChanged.wait(lock, [&] { return turn == chunk || failed; });
+					if (failed)
+						return;
+					try
+					{
+						// other threads keep formatting while this one writes
+						lock.unlock();
+						writeAll(fd, buffer.data(), static_cast<std::size_t>(end - buffer.data()));
+						lock.lock();
+						++turn;
+					}
+					catch (...)
+					{
+						lock.lock();
+						failed = true;
+						turnChanged.notify_all();
+						throw;
+					}
+					turnChanged.notify_all();
+				}
+			};
+
+			if (threads == 1)
+			{
+				work(0);
+				return;
+			}
+
+			std::vector<std::thread> workers {};
+			std::exception_ptr error {};
+			for (unsigned t { 1 }; t < threads; ++t)
+				workers.emplace_back([&, t]
+				{
+					try
+					{
+						work(t);
+					}
+					catch (...)
+					{
+						const std::lock_guard lock { mutex };
+						error = std::current_exception();
+					}
+				});
+			try
+			{
+				work(0);
+			}
+			catch (...)
+			{
+				const std::lock_guard lock { mutex };
+				error = std::current_exception();
+			}
+			for (auto& worker : workers)
+				worker.join();
+			if (error)
+				std::rethrow_exception(error);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,175 @@
+// fizzbuzz() vs FizzBuzz::Engine
+// Build with: clang++ -std=c++17 -O2 -pthread main.cpp -o fizzbuzz
+// Run with:   ./fizzbuzz                        the 150 lines of question6
+//             ./fizzbuzz count [threads]        1..count to standard output, e.g. ./fizzbuzz 1000000000 4 | pv > /dev/null
+//             ./fizzbuzz --benchmark [count]    fizzbuzz() vs the engine, written to /dev/null
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "FizzBuzz.h"
+
+// The original, writing to any stream, used as the reference
+void fizzbuzz(int count, std::ostream& out = std::cout)
+{
+	// We'll make these static so we only have to do initialization once
+	static const std::vector divisors                { 3, 5, 7, 11, 13, 17, 19 };
+	static const std::vector<std::string_view> words { "fizz", "buzz", "pop", "bang", "jazz", "pow", "boom" };
+	assert(std::size(divisors) == std::size(words) && "fizzbuzz: array sizes don't match");
+
+	// Loop through each number between 1 and count (inclusive)
+	for (int i{ 1 }; i <= count; ++i)
+	{
+		bool printed{ false };
+
+		// Check the current number against each possible divisor
+		for (std::size_t j{ 0 }; j < divisors.size(); ++j)
+		{
+			if (i % divisors[j] == 0)
+			{
+				out << words[j];
+				printed = true;
+			}
+		}
+
+		// If there were no divisors
+		if (!printed)
+			out << i;
+
+		out << '\n';
+	}
+}
+
+// Lines first..last of the original, one by one
+std::string reference(std::uint64_t first, std::uint64_t last,
+	const std::vector<std::uint64_t>& divisors, const std::vector<std::string>& words)
+{
+	std::string text {};
+	for (std::uint64_t i{ first }; i <= last; ++i)
+	{
+		bool printed{ false };
+		for (std::size_t j{ 0 }; j < divisors.size(); ++j)
+		{
+			if (i % divisors[j] == 0)
+			{
+				text += words[j];
+				printed = true;
+			}
+		}
+		if (!printed)
+			text += std::to_string(i);
+		text += '\n';
+	}
+	return text;
+}
+
+void checkEngine()
+{
+	const FizzBuzz::Engine classic { FizzBuzz::Engine::classic() };
+	assert(classic.mode() == FizzBuzz::Engine::Mode::wheel);
+
+	std::ostringstream original {};
+	fizzbuzz(150, original);
+	assert(classic.toString(1, 150) == original.str());
+
+	// the decimal counter across lengths, the wheel across its end, counters mode with a huge lcm
+	const std::vector<std::uint64_t> classicDivisors { 3, 5, 7, 11, 13, 17, 19 };
+	const std::vector<std::string> classicWords { "fizz", "buzz", "pop", "bang", "jazz", "pow", "boom" };
+	const std::vector<std::uint64_t> bigDivisors { 2, 999'983, 1'000'003 };
+	const std::vector<std::string> bigWords { "even", "big", "bigger" };
+	const FizzBuzz::Engine big { bigDivisors, bigWords };
+	assert(big.mode() == FizzBuzz::Engine::Mode::counters);
+
+	for (const auto& [first, last] : { std::pair<std::uint64_t, std::uint64_t>{ 1, 1 },
+		{ 90, 1010 }, { 999'990, 1'000'010 }, { 4'849'800, 4'849'900 },
+		{ 999'982'999'990, 999'983'000'010 }, { 9'999'999'999'990, 10'000'000'000'010 } })
+	{
+		assert(classic.toString(first, last) == reference(first, last, classicDivisors, classicWords));
+		assert(big.toString(first, last) == reference(first, last, bigDivisors, bigWords));
+	}
+
+	// chunks written in order by several threads, to an anonymous temporary file (deleted when closed)
+	const std::uint64_t count { 3 * FizzBuzz::Engine::chunkNumbers + 12345 };
+	const std::string expected { classic.toString(1, count) };
+	for (unsigned threads : { 1u, 2u, 3u })
+	{
+		std::FILE* file { std::tmpfile() };
+		assert(file);
+		const int fd { ::fileno(file) };
+		classic.write(fd, count, threads);
+
+		std::string written(expected.size() + 1, '\0'); // one more byte: catches extra output
+		std::size_t size { 0 };
+		::lseek(fd, 0, SEEK_SET);
+		for (ssize_t n; (n = ::read(fd, &written[size], written.size() - size)) > 0;)
+			size += static_cast<std::size_t>(n);
+		written.resize(size);
+		std::fclose(file);
+		assert(written == expected);
+	}
+}
+
+void benchmark(std::uint64_t count)
+{
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	const FizzBuzz::Engine classic { FizzBuzz::Engine::classic() };
+	const double gb { static_cast<double>(classic.toString(1, 1'000'000).size()) * static_cast<double>(count) / 1e6 / 1e9 };
+
+	// the original is far slower: time a hundredth of the numbers
+	std::ofstream devNull { "/dev/null" };
+	auto start { Clock::now() };
+	fizzbuzz(static_cast<int>(count / 100), devNull);
+	devNull.flush();
+	const Seconds originalTime { (Clock::now() - start) * 100 };
+
+	std::cout << count << " lines (about " << gb << " GB), extrapolated from " << count / 100 << " for fizzbuzz():\n"
+		<< "  fizzbuzz():      " << originalTime.count() << " s (" << gb / originalTime.count() << " GB/s)\n";
+
+	const int fd { ::open("/dev/null", O_WRONLY) };
+	assert(fd >= 0);
+	const unsigned hardwareThreads { std::max(1u, std::thread::hardware_concurrency()) };
+	for (unsigned threads : { 1u, hardwareThreads })
+	{
+		start = Clock::now();
+		classic.write(fd, count, threads);
+		const Seconds time { Clock::now() - start };
+		std::cout << "  engine, " << threads << " thread(s): " << time.count() << " s (" << gb / time.count() << " GB/s)\n";
+		if (hardwareThreads == 1)
+			break;
+	}
+	::close(fd);
+}
+
+int main(int argc, char* argv[])
+{
+	checkEngine();
+
+	const std::string argument { argc > 1 ? argv[1] : "" };
+	if (argument == "--benchmark")
+	{
+		benchmark(argc > 2 ? std::stoull(argv[2]) : 1'000'000'000);
+		return 0;
+	}
+	if (!argument.empty())
+	{
+		const unsigned threads { argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 0u };
+		FizzBuzz::Engine::classic().write(STDOUT_FILENO, std::stoull(argument), threads);
+		return 0;
+	}
+
+	fizzbuzz(150);
+
+	return 0;
+}
@@ -0,0 +1,302 @@
+// SearchIndex<T>: many lookups against the same array without a linear scan each time
+//
+// findIndex() and isValueInArray() look at every element on every call. When the array does not
+// change and we query it many times, it pays off to build an index once:
+// * hashed: open-addressing hash table (linear probing, power-of-two capacity, at most 50% full)
+// * sorted: the distinct values sorted and stored in Eytzinger (breadth-first) order, so a binary
+//   search walks down the array with a branch-free loop and a predictable memory pattern
+// * linear: no index at all, for tiny arrays or when there are too few queries to pay for one
+// The mode is picked from the array size and the expected number of queries (see chooseMode()),
+// or can be forced. Every mode answers like the original findIndex(): the index of the *first*
+// occurrence of the value, or -1.
+//
+// Values are copied into the index, so use a cheap key type: for text, std::string_view keys
+// (hashed with std::hash<std::string_view>) refer to the caller's strings without copying them.
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace SearchDetail
+{
+    // true when std::hash<T> is usable
+    template <typename T, typename = void>
+    struct IsHashable : std::false_type {};
+
+    template <typename T>
+    struct IsHashable<T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>> : std::true_type {};
+}
+
+template <typename T>
+class SearchIndex
+{
+public:
+    enum class Mode
+    {
+        linear,
+        hashed,
+        sorted,
+    };
+
+    // queries == 0 means "unknown, assume many"
+    static Mode chooseMode(std::size_t size, std::size_t queries = 0)
+    {
+        // A scan of a few elements is as fast as any lookup
+        if (size <= linearLimit)
+            return Mode::linear;
+
+        // Building costs about one pass over the array per log2(size) scans avoided
+        std::size_t log2Size { 0 };
+        while ((std::size_t{ 1 } << log2Size) < size)
+            ++log2Size;
+        if (queries != 0 && queries <= log2Size)
+            return Mode::linear;
+
+        if constexpr (SearchDetail::IsHashable<T>::value)
+            return Mode::hashed;
+        else
+            return Mode::sorted;
+    }
+
+private:
+    static constexpr std::size_t linearLimit { 16 };
+    static constexpr std::uint32_t emptySlot { 0 };
+
+    Mode m_mode {};
+
+    // linear mode: the values themselves
+    std::vector<T> m_values {};
+
+    // hashed and sorted modes: one entry per distinct value, with the index of its first occurrence
+    std::vector<T> m_keys {};
+    std::vector<int> m_positions {};
+
+    // hashed mode: slot -> 1 + position in m_keys (0 = empty)
+    std::vector<std::uint32_t> m_slots {};
+    std::size_t m_mask {};
+
+    // ----- hashed -----
+
+    static std::size_t hashOf(const T& value)
+    {
+        // mix the bits: std::hash of an integer is often the identity, which clusters badly
+        std::uint64_t h { static_cast<std::uint64_t>(std::hash<T>{}(value)) };
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
+    }
+
+    void buildHashed(const std::vector<T>& values)
+    {
+        std::size_t capacity { 16 };
+        while (capacity < 2 * values.size())
+            capacity *= 2;
+        m_slots.assign(capacity, emptySlot);
+        m_mask = capacity - 1;
+
+        for (std::size_t i { 0 }; i < values.size(); ++i)
+        {
+            std::size_t slot { hashOf(values[i]) & m_mask };
+            while (m_slots[slot] != emptySlot && !(m_keys[m_slots[slot] - 1] == values[i]))
+                slot = (slot + 1) & m_mask;
+
+            if (m_slots[slot] == emptySlot) // first occurrence only
+            {
+                m_keys.push_back(values[i]);
+                m_positions.push_back(static_cast<int>(i));
+                m_slots[slot] = static_cast<std::uint32_t>(m_keys.size());
+            }
+        }
+    }
+
+    int findHashed(const T& value, std::size_t hash) const
+    {
+        for (std::size_t slot { hash & m_mask }; m_slots[slot] != emptySlot; slot = (slot + 1) & m_mask)
+        {
+            const std::uint32_t entry { m_slots[slot] - 1 };
+            if (m_keys[entry] == value)
+                return m_positions[entry];
+        }
+        return -1;
+    }
+
+    // ----- sorted (Eytzinger layout, 1-based: the children of k are 2k and 2k + 1) -----
+
+    void buildSorted(const std::vector<T>& values)
+    {
+        std::vector<std::pair<T, int>> sorted {};
+        sorted.reserve(values.size());
+        for (std::size_t i { 0 }; i < values.size(); ++i)
+            sorted.emplace_back(values[i], static_cast<int>(i));
+
+        // stable, so the first occurrence of every value comes first among equals
+        std::stable_sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+        sorted.erase(std::unique(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return !(a.first < b.first) && !(b.first < a.first); }), sorted.end());
+
+        m_keys.assign(sorted.size() + 1, T{});
+        m_positions.assign(sorted.size() + 1, -1);
+        std::size_t next { 0 };
+        fillEytzinger(sorted, next, 1);
+    }
+
+    void fillEytzinger(const std::vector<std::pair<T, int>>& sorted, std::size_t& next, std::size_t k)
+    {
+        if (k >= m_keys.size())
+            return;
+        fillEytzinger(sorted, next, 2 * k);
+        m_keys[k] = sorted[next].first;
+        m_positions[k] = sorted[next].second;
+        ++next;
+        fillEytzinger(sorted, next, 2 * k + 1);
+    }
+
+    // Position in m_keys of the first key >= value (0 if there is none)
+    std::size_t lowerBoundSorted(const T& value) const
+    {
+        const std::size_t n { m_keys.size() - 1 };
+        std::size_t k { 1 };
+        while (k <= n)
+        {
+            __builtin_prefetch(m_keys.data() + std::min(16 * k, n)); // four levels ahead
+            k = 2 * k + (m_keys[k] < value);
+        }
+        // undo the right turns taken after the last left turn
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+        return k;
+    }
+
+    int findSorted(const T& value) const
+    {
+        const std::size_t k { lowerBoundSorted(value) };
+        return (k != 0 && !(value < m_keys[k])) ? m_positions[k] : -1;
+    }
+
+    // ----- linear -----
+
+    int findLinear(const T& value) const
+    {
+        for (std::size_t index { 0 }; index < m_values.size(); ++index)
+            if (m_values[index] == value)
+                return static_cast<int>(index);
+        return -1;
+    }
+
+public:
+    // Picks the mode with chooseMode(values.size(), expectedQueries)
+    explicit SearchIndex(const std::vector<T>& values, std::size_t expectedQueries = 0)
+    : SearchIndex(values, chooseMode(values.size(), expectedQueries))
+    {}
+
+    SearchIndex(const std::vector<T>& values, Mode mode)
+    : m_mode { mode }
+    {
+        switch (m_mode)
+        {
+            case Mode::linear: m_values = values; break;
+            case Mode::hashed:
+                if constexpr (SearchDetail::IsHashable<T>::value)
+                {
+                    buildHashed(values);
+                    break;
+                }
+                // not hashable: fall back to the sorted layout
+                m_mode = Mode::sorted;
+                [[fallthrough]];
+            case Mode::sorted: buildSorted(values); break;
+        }
+    }
+
+    Mode mode() const { return m_mode; }
+
+    // Index of the first occurrence of value, or -1
+    int findIndex(const T& value) const
+    {
+        switch (m_mode)
+        {
+            case Mode::linear: return findLinear(value);
+            case Mode::hashed:
+                if constexpr (SearchDetail::IsHashable<T>::value)
+                    return findHashed(value, hashOf(value));
+                break;
+            case Mode::sorted: return findSorted(value);
+        }
+        return -1;
+    }
+
+    bool contains(const T& value) const { return findIndex(value) != -1; }
+
+    // out[i] = findIndex(keys[i]) for count keys.
+    // Keys are handled in small groups: the memory accesses of a whole group are started
+    // before waiting for any of them, instead of one cache miss after the other.
+    void findIndices(const T* keys, std::size_t count, int* out) const
+    {
+        constexpr std::size_t group { 16 };
+
+        if (m_mode == Mode::hashed)
+        {
+            if constexpr (SearchDetail::IsHashable<T>::value)
+            {
+                std::size_t hashes[group] {};
+                for (std::size_t begin { 0 }; begin < count; begin += group)
+                {
+                    const std::size_t size { std::min(group, count - begin) };
+                    for (std::size_t i { 0 }; i < size; ++i)
+                    {
+                        hashes[i] = hashOf(keys[begin + i]);
+                        __builtin_prefetch(m_slots.data() + (hashes[i] & m_mask));
+                    }
+                    for (std::size_t i { 0 }; i < size; ++i)
+                        out[begin + i] = findHashed(keys[begin + i], hashes[i]);
+                }
+                return;
+            }
+        }
+
+        if (m_mode == Mode::sorted)
+        {
+            // walk the tree for the whole group one level at a time
+            const std::size_t n { m_keys.size() - 1 };
+            std::size_t k[group] {};
+            for (std::size_t begin { 0 }; begin < count; begin += group)
+            {
+                const std::size_t size { std::min(group, count - begin) };
+                std::fill(k, k + size, std::size_t{ 1 });
+                for (std::size_t level { 1 }; level <= n; level = 2 * level + 1)
+                    for (std::size_t i { 0 }; i < size; ++i)
+                        k[i] = 2 * k[i] + (m_keys[k[i]] < keys[begin + i]);
+                for (std::size_t i { 0 }; i < size; ++i)
+                {
+                    // keys deeper than the last full level still need their last step
+                    std::size_t node { k[i] };
+                    while (node <= n)
+                        node = 2 * node + (m_keys[node] < keys[begin + i]);
+                    node >>= __builtin_ffsll(static_cast<long long>(~node));
+                    out[begin + i] = (node != 0 && !(keys[begin + i] < m_keys[node])) ? m_positions[node] : -1;
+                }
+            }
+            return;
+        }
+
+        for (std::size_t i { 0 }; i < count; ++i)
+            out[i] = findIndex(keys[i]);
+    }
+
+    std::vector<int> findIndices(const std::vector<T>& keys) const
+    {
+        std::vector<int> result(keys.size());
+        findIndices(keys.data(), keys.size(), result.data());
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,160 @@
+// Many lookups against the same array: findIndex() / isValueInArray() vs SearchIndex<T>
+// Build with: clang++ -std=c++17 -O2 main.cpp -o search
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SearchIndex.h"
+
+// The originals, used as the reference
+template <typename T>
+int findIndex(const std::vector<T>& array, T value)
+{
+    for (std::size_t index {0}; index < array.size(); ++index)
+    {
+        if (array[index] == value)
+        {
+            return static_cast<int>(index);
+        }
+    }
+    return -1; // value not found
+}
+
+template <typename T>
+bool isValueInArray(const std::vector<T>& arr, const T& value )
+{
+    for (const auto& a : arr)
+    {
+        if (a == value)
+            return true;
+    }
+
+    return false;
+}
+
+// Every mode must give the same answers as findIndex(), duplicates and missing values included
+template <typename T>
+void checkModes(const std::vector<T>& values, const std::vector<T>& keys)
+{
+    using Index = SearchIndex<T>;
+    for (auto mode : { Index::Mode::linear, Index::Mode::hashed, Index::Mode::sorted })
+    {
+        const Index index { values, mode };
+        const std::vector<int> batch { index.findIndices(keys) };
+        for (std::size_t i { 0 }; i < keys.size(); ++i)
+        {
+            const int expected { findIndex(values, keys[i]) };
+            assert(index.findIndex(keys[i]) == expected);
+            assert(batch[i] == expected);
+            assert(index.contains(keys[i]) == isValueInArray(values, keys[i]));
+        }
+    }
+}
+
+template <typename F>
+double timeMs(F fn)
+{
+    const auto start { std::chrono::steady_clock::now() };
+    fn();
+    return std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count();
+}
+
+int main()
+{
+    // the arrays from the exercises
+    const std::vector arr { 4, 6, 7, 3, 8, 2, 1, 9 };
+    const SearchIndex index { arr };
+    assert(index.mode() == SearchIndex<int>::Mode::linear); // 8 elements: not worth an index
+    assert(index.findIndex(8) == 4 && index.findIndex(5) == -1);
+
+    const std::vector<std::string_view> names { "Alex", "Betty", "Caroline", "Dave",
+        "Emily", "Fred", "Greg", "Holly" };
+    const SearchIndex<std::string_view> nameIndex { names, SearchIndex<std::string_view>::Mode::hashed };
+
+    std::cout << "Enter a name: ";
+    std::string username {};
+    std::cin >> username;
+    if (nameIndex.contains(username))
+        std::cout << username << " was found.\n";
+    else
+        std::cout << username << " was not found.\n";
+
+    // correctness on random data
+    std::mt19937 rng { 42 };
+    for (std::size_t size : { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 4097 })
+    {
+        std::uniform_int_distribution pick { 0, static_cast<int>(size) + 10 };
+        std::vector<int> values(size);
+        for (auto& v : values)
+            v = pick(rng);
+        std::vector<int> keys(500);
+        for (auto& k : keys)
+            k = pick(rng);
+        checkModes(values, keys);
+
+        std::vector<double> doubles(values.begin(), values.end());
+        std::vector<double> doubleKeys(keys.begin(), keys.end());
+        checkModes(doubles, doubleKeys);
+    }
+
+    // string_view keys over strings owned elsewhere: the index never copies the characters
+    std::vector<std::string> storage {};
+    for (int i { 0 }; i < 2000; ++i)
+        storage.push_back("name" + std::to_string(i * 7919 % 2003));
+    std::vector<std::string_view> views(storage.begin(), storage.end());
+    std::vector<std::string_view> viewKeys(views.begin(), views.begin() + 300);
+    viewKeys.push_back("nobody");
+    checkModes(views, viewKeys);
+
+    std::cout << "Success!\n";
+
+    // Benchmark: one array, many queries, half of them missing
+    constexpr std::size_t size { 1'000'000 };
+    constexpr std::size_t queries { 1'000'000 };
+    constexpr std::size_t linearQueries { 1'000 }; // the scan is too slow for all of them
+
+    std::uniform_int_distribution pick { 0, 2 * static_cast<int>(size) };
+    std::vector<int> values(size);
+    for (auto& v : values)
+        v = pick(rng);
+    std::vector<int> keys(queries);
+    for (auto& k : keys)
+        k = pick(rng);
+
+    long long sink { 0 };
+    const double linearMs { timeMs([&] {
+        for (std::size_t i { 0 }; i < linearQueries; ++i)
+            sink += findIndex(values, keys[i]);
+    }) };
+    std::cout << size << " ints, " << queries << " queries (ns per query)\n"
+              << "  findIndex():     " << linearMs * 1e6 / linearQueries << '\n';
+
+    using Index = SearchIndex<int>;
+    std::cout << "  chooseMode() picks " << (Index::chooseMode(size, queries) == Index::Mode::hashed ? "hashed" : "sorted") << '\n';
+    for (auto mode : { Index::Mode::hashed, Index::Mode::sorted })
+    {
+        const char* name { mode == Index::Mode::hashed ? "hashed" : "sorted" };
+        Index search { values, Index::Mode::linear };
+        const double buildMs { timeMs([&] { search = Index{ values, mode }; }) };
+
+        const double singleMs { timeMs([&] {
+            for (const int k : keys)
+                sink += search.findIndex(k);
+        }) };
+
+        std::vector<int> results {};
+        const double batchMs { timeMs([&] { results = search.findIndices(keys); }) };
+        for (std::size_t i { 0 }; i < linearQueries; ++i)
+            assert(results[i] == findIndex(values, keys[i]));
+
+        std::cout << "  " << name << ": build " << buildMs << " ms, one by one " << singleMs * 1e6 / queries
+                  << ", batched " << batchMs * 1e6 / queries << '\n';
+    }
+
+    std::cout << "  (checksum " << sink << ")\n"; // uses sink, so the loops are not optimized away
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Faster findMinMaxIndices() for huge arrays of int and double
+//
+// The scalar version compares every element against v[minIndex] and v[maxIndex]: two dependent
+// branches per element, nothing the compiler can vectorize. Here the array is processed in small
+// blocks that stay in L1 cache:
+// 1. the min and max *values* of the block are found with SIMD min/max over several lanes
+//    (AVX2 when compiled with -mavx2, a plain loop the compiler can vectorize otherwise);
+// 2. only when the block beats the best values so far, the block is scanned again (from L1) to
+//    find the index of the first occurrence.
+// Since blocks are visited in order and only a strictly better value replaces the current one,
+// the result is the same as the original loop: the first minimum and the first maximum.
+// The parallel version splits the array in one contiguous chunk per thread and merges the
+// per-chunk results in order, with the same tie rule.
+//
+// As with the original, the array must not contain NaN.
+
+#ifndef MINMAX_H
+#define MINMAX_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace MinMax
+{
+    // Elements per block: 4096 ints (16 KiB) or 4096 doubles (32 KiB)
+    constexpr std::size_t blockSize { 4096 };
+
+    // Min and max value of data[0, count), count >= 1
+    template <typename T>
+    void blockMinMax(const T* data, std::size_t count, T& minValue, T& maxValue)
+    {
+        T mn { data[0] };
+        T mx { data[0] };
+        for (std::size_t i { 1 }; i < count; ++i)
+        {
+            mn = data[i] < mn ? data[i] : mn;
+            mx = data[i] > mx ? data[i] : mx;
+        }
+        minValue = mn;
+        maxValue = mx;
+    }
+
+#if defined(__AVX2__)
+    inline void blockMinMax(const int* data, std::size_t count, int& minValue, int& maxValue)
+    {
+        std::size_t i { 0 };
+        int mn { data[0] };
+        int mx { data[0] };
+        if (count >= 16)
+        {
+            // two independent accumulators per operation, to hide the instruction latency
+            __m256i mn0 { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)) };
+            __m256i mn1 { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8)) };
+            __m256i mx0 { mn0 };
+            __m256i mx1 { mn1 };
+            for (i = 16; i + 16 <= count; i += 16)
+            {
+                const __m256i a { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)) };
+                const __m256i b { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8)) };
+                mn0 = _mm256_min_epi32(mn0, a);
+                mn1 = _mm256_min_epi32(mn1, b);
+                mx0 = _mm256_max_epi32(mx0, a);
+                mx1 = _mm256_max_epi32(mx1, b);
+            }
+            alignas(32) int lanesMin[8] {};
+            alignas(32) int lanesMax[8] {};
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMin), _mm256_min_epi32(mn0, mn1));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMax), _mm256_max_epi32(mx0, mx1));
+            mn = *std::min_element(lanesMin, lanesMin + 8);
+            mx = *std::max_element(lanesMax, lanesMax + 8);
+        }
+        for (; i < count; ++i)
+        {
+            mn = std::min(mn, data[i]);
+            mx = std::max(mx, data[i]);
+        }
+        minValue = mn;
+        maxValue = mx;
+    }
+
+    inline void blockMinMax(const double* data, std::size_t count, double& minValue, double& maxValue)
+    {
+        std::size_t i { 0 };
+        double mn { data[0] };
+        double mx { data[0] };
+        if (count >= 8)
+        {
+            __m256d mn0 { _mm256_loadu_pd(data) };
+            __m256d mn1 { _mm256_loadu_pd(data + 4) };
+            __m256d mx0 { mn0 };
+            __m256d mx1 { mn1 };
+            for (i = 8; i + 8 <= count; i += 8)
+            {
+                const __m256d a { _mm256_loadu_pd(data + i) };
+                const __m256d b { _mm256_loadu_pd(data + i + 4) };
+                mn0 = _mm256_min_pd(mn0, a);
+                mn1 = _mm256_min_pd(mn1, b);
+                mx0 = _mm256_max_pd(mx0, a);
+                mx1 = _mm256_max_pd(mx1, b);
+            }
+            alignas(32) double lanesMin[4] {};
+            alignas(32) double lanesMax[4] {};
+            _mm256_store_pd(lanesMin, _mm256_min_pd(mn0, mn1));
+            _mm256_store_pd(lanesMax, _mm256_max_pd(mx0, mx1));
+            mn = *std::min_element(lanesMin, lanesMin + 4);
+            mx = *std::max_element(lanesMax, lanesMax + 4);
+        }
+        for (; i < count; ++i)
+        {
+            mn = std::min(mn, data[i]);
+            mx = std::max(mx, data[i]);
+        }
+        minValue = mn;
+        maxValue = mx;
+    }
+#endif
+
+    // Indices of the first minimum and first maximum of data[0, count), count >= 1
+    template <typename T>
+    std::pair<std::size_t, std::size_t> findMinMaxIndices(const T* data, std::size_t count)
+    {
+        assert(count > 0 && "findMinMaxIndices() needs at least one element");
+
+        std::size_t minIndex { 0 };
+        std::size_t maxIndex { 0 };
+        T minValue { data[0] };
+        T maxValue { data[0] };
+
+        for (std::size_t begin { 0 }; begin < count; begin += blockSize)
+        {
+            const std::size_t size { std::min(blockSize, count - begin) };
+            const T* block { data + begin };
+
+            T blockMin {};
+            T blockMax {};
+            blockMinMax(block, size, blockMin, blockMax);
+
+            // the block is still in L1, so looking for the first occurrence again is cheap
+            if (blockMin < minValue)
+            {
+                minValue = blockMin;
+                minIndex = begin + static_cast<std::size_t>(std::find(block, block + size, blockMin) - block);
+            }
+            if (blockMax > maxValue)
+            {
+                maxValue = blockMax;
+                maxIndex = begin + static_cast<std::size_t>(std::find(block, block + size, blockMax) - block);
+            }
+        }
+
+        return { minIndex, maxIndex };
+    }
+
+    // Same as above, with the array split in one chunk per thread (threads == 0: every hardware thread)
+    template <typename T>
+    std::pair<std::size_t, std::size_t> findMinMaxIndices(const std::vector<T>& v, unsigned threads = 1)
+    {
+        assert(!v.empty() && "findMinMaxIndices() needs at least one element");
+
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        // no point in chunks smaller than a few blocks
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, (v.size() + 16 * blockSize - 1) / (16 * blockSize)));
+
+        if (threads <= 1)
+            return findMinMaxIndices(v.data(), v.size());
+
+        std::vector<std::pair<std::size_t, std::size_t>> partial(threads);
+        auto work = [&](unsigned t)
+        {
+            const std::size_t begin { v.size() * t / threads };
+            const std::size_t end { v.size() * (t + 1) / threads };
+            const auto result { findMinMaxIndices(v.data() + begin, end - begin) };
+            partial[t] = { begin + result.first, begin + result.second };
+        };
+
+        std::vector<std::thread> workers {};
+        for (unsigned t { 1 }; t < threads; ++t)
+            workers.emplace_back(work, t);
+        work(0);
+        for (auto& worker : workers)
+            worker.join();
+
+        // merge in chunk order: a later chunk only wins with a strictly better value
+        auto result { partial[0] };
+        for (unsigned t { 1 }; t < threads; ++t)
+        {
+            if (v[partial[t].first] < v[result.first])
+                result.first = partial[t].first;
+            if (v[partial[t].second] > v[result.second])
+                result.second = partial[t].second;
+        }
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,132 @@
+// findMinMaxIndices() on huge arrays: original template vs MinMax::findMinMaxIndices()
+// Build with: clang++ -std=c++17 -O2 -mavx2 -pthread main.cpp -o minmax
+// Run with:   ./minmax [elements]   (default 100'000'000; 1'000'000'000 ints need 4 GB of memory)
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MinMax.h"
+
+// The original version from question3, used as the reference
+template <typename T>
+std::pair<std::size_t, std::size_t> findMinMaxIndices(const std::vector<T>& v)
+{
+    // Assume element 0 is the minimum and the maximum
+    std::size_t minIndex { 0 };
+    std::size_t maxIndex { 0 };
+
+    // Look through the remaining elements to see if we can find a smaller or larger element
+    for (std::size_t index { 1 }; index < v.size(); ++index)
+    {
+        if (v[index] < v[minIndex])
+            minIndex = index;
+        if (v[index] > v[maxIndex])
+            maxIndex = index;
+    }
+
+    return { minIndex, maxIndex };
+}
+
+template <typename T>
+void printArray(const std::vector<T>& v)
+{
+    bool comma { false };
+    std::cout << "With array ( ";
+    for (const auto& e: v)
+    {
+        if (comma)
+            std::cout << ", ";
+
+        std::cout << e;
+        comma = true;
+    }
+    std::cout << " ):\n";
+}
+
+// Random arrays with lots of repeated values, so first-occurrence ties are exercised
+template <typename T>
+void checkAgainstReference(std::mt19937& rng)
+{
+    for (std::size_t size : { 1, 2, 7, 15, 16, 17, 100, 4095, 4096, 4097, 100'000, 1'000'003 })
+    {
+        std::uniform_int_distribution values { -50, 50 };
+        std::vector<T> v(size);
+        for (auto& e : v)
+            e = static_cast<T>(values(rng));
+
+        const auto expected { findMinMaxIndices(v) };
+        assert(MinMax::findMinMaxIndices(v.data(), v.size()) == expected);
+        assert(MinMax::findMinMaxIndices(v, 3) == expected);
+        assert(MinMax::findMinMaxIndices(v, 0) == expected);
+    }
+}
+
+template <typename T>
+void benchmark(const char* name, std::size_t size, std::mt19937& rng)
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    std::vector<T> v(size);
+    std::uniform_int_distribution values { -1'000'000'000, 1'000'000'000 };
+    for (auto& e : v)
+        e = static_cast<T>(values(rng));
+
+    auto start { Clock::now() };
+    const auto reference { findMinMaxIndices(v) };
+    const Ms referenceTime { Clock::now() - start };
+
+    start = Clock::now();
+    const auto simd { MinMax::findMinMaxIndices(v.data(), v.size()) };
+    const Ms simdTime { Clock::now() - start };
+
+    const unsigned threads { std::max(1u, std::thread::hardware_concurrency()) };
+    start = Clock::now();
+    const auto parallel { MinMax::findMinMaxIndices(v, threads) };
+    const Ms parallelTime { Clock::now() - start };
+
+    assert(simd == reference && parallel == reference);
+
+    const double gb { static_cast<double>(size * sizeof(T)) / 1e9 };
+    std::cout << name << ", " << size << " elements:\n"
+              << "  original:             " << referenceTime.count() << " ms\n"
+              << "  blocked SIMD:         " << simdTime.count() << " ms (" << gb / (simdTime.count() / 1000) << " GB/s)\n"
+              << "  parallel (" << threads << " threads): " << parallelTime.count() << " ms (" << gb / (parallelTime.count() / 1000) << " GB/s)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector v1 { 3, 8, 2, 5, 7, 8, 3 };
+    printArray(v1);
+
+    auto m1 { MinMax::findMinMaxIndices(v1) };
+    std::cout << "The min element has index " << m1.first << " and value " << v1[m1.first] << '\n';
+    std::cout << "The max element has index " << m1.second << " and value " << v1[m1.second] << '\n';
+    assert(m1.first == 2 && m1.second == 1); // first occurrence of 8
+
+    std::cout << '\n';
+
+    std::vector v2 { 5.5, 2.7, 3.3, 7.6, 1.2, 8.8, 6.6 };
+    printArray(v2);
+
+    auto m2 { MinMax::findMinMaxIndices(v2) };
+    std::cout << "The min element has index " << m2.first << " and value " << v2[m2.first] << '\n';
+    std::cout << "The max element has index " << m2.second << " and value " << v2[m2.second] << '\n';
+
+    std::cout << '\n';
+
+    std::mt19937 rng { 42 };
+    checkAgainstReference<int>(rng);
+    checkAgainstReference<double>(rng);
+
+    const std::size_t size { argc > 1 ? std::stoull(argv[1]) : 100'000'000 };
+    benchmark<int>("int", size, rng);
+    benchmark<double>("double", size, rng);
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+// Reading huge amounts of whitespace-separated integers without std::cin
+//
+// `std::cin >> input` goes through locales, sentries and virtual calls for every number, and a
+// bad token needs the clear()/ignore() dance. For files of gigabytes we instead:
+// * read the input in large blocks with one system call each (a line at a time from a terminal,
+//   since read() returns whatever is available);
+// * find the token boundaries 64 bytes at a time: a bit mask of the whitespace bytes (AVX2 when
+//   compiled with -mavx2, a plain loop otherwise) gives every token start and end with a few
+//   bit operations, instead of testing the bytes one by one;
+// * convert each token with std::from_chars, which does no locale lookup and no allocation.
+// A malformed token ("12abc", "x", a value out of range) is counted and skipped, nothing else is
+// lost. A token cut by the end of a block is moved to the front of the buffer and finished with
+// the next block.
+//
+// Values are handed to a callback as they are parsed, so nothing has to be stored: see
+// RunningMinMax for the min/max of the stream.
+
+#ifndef NUMBERSTREAM_H
+#define NUMBERSTREAM_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace NumberStream
+{
+    constexpr std::size_t defaultBlockSize { 1 << 20 };
+
+    // Longer tokens can't be a valid number of any integer type: they are malformed
+    constexpr std::size_t maxTokenLength { 64 };
+
+    struct Counts
+    {
+        std::size_t values {};    // numbers handed to the callback
+        std::size_t malformed {}; // tokens skipped
+        bool stopped {};          // the callback asked to stop
+    };
+
+    // First minimum and first maximum of a stream, like findMinMaxIndices() without the vector
+    template <typename T>
+    class RunningMinMax
+    {
+    private:
+        std::size_t m_count {};
+        std::size_t m_minIndex {};
+        std::size_t m_maxIndex {};
+        T m_minValue {};
+        T m_maxValue {};
+
+    public:
+        void add(T value)
+        {
+            if (m_count == 0 || value < m_minValue)
+            {
+                m_minValue = value;
+                m_minIndex = m_count;
+            }
+            if (m_count == 0 || value > m_maxValue)
+            {
+                m_maxValue = value;
+                m_maxIndex = m_count;
+            }
+            ++m_count;
+        }
+
+        bool empty() const { return m_count == 0; }
+        std::size_t count() const { return m_count; }
+        std::size_t minIndex() const { return m_minIndex; }
+        std::size_t maxIndex() const { return m_maxIndex; }
+        T minValue() const { return m_minValue; }
+        T maxValue() const { return m_maxValue; }
+    };
+
+    namespace detail
+    {
+        // Bit i set when data[i] is whitespace (any byte <= ' ', as isspace() in the "C" locale
+        // plus the other control characters)
+        inline std::uint64_t whitespaceMask(const char* data)
+        {
+#if defined(__AVX2__)
+            const __m256i space { _mm256_set1_epi8(' ') };
+            const __m256i a { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)) };
+            const __m256i b { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)) };
+            // unsigned x <= ' ' exactly when max(x, ' ') == ' '
+            const __m256i wsA { _mm256_cmpeq_epi8(_mm256_max_epu8(a, space), space) };
+            const __m256i wsB { _mm256_cmpeq_epi8(_mm256_max_epu8(b, space), space) };
+            const auto low { static_cast<std::uint32_t>(_mm256_movemask_epi8(wsA)) };
+            const auto high { static_cast<std::uint32_t>(_mm256_movemask_epi8(wsB)) };
+            return (std::uint64_t{ high } << 32) | low;
+#else
+            std::uint64_t mask { 0 };
+            for (unsigned i { 0 }; i < 64; ++i)
+                mask |= std::uint64_t{ static_cast<unsigned char>(data[i]) <= ' ' } << i;
+            return mask;
+#endif
+        }
+
+        struct State
+        {
+            Counts counts {};
+            bool skipping {}; // the token at the start of the block is the rest of a malformed one
+        };
+
+        template <typename T, typename Callback>
+        void parseToken(const char* begin, const char* end, State& state, Callback& onValue)
+        {
+            // std::from_chars does not take a leading '+', operator>> does
+            if (end - begin > 1 && *begin == '+' && begin[1] != '-')
+                ++begin;
+
+            T value {};
+            const auto [ptr, ec] { std::from_chars(begin, end, value) };
+            if (ec != std::errc{} || ptr != end)
+            {
+                ++state.counts.malformed;
+                return;
+            }
+            ++state.counts.values;
+            if (!onValue(value))
+                state.counts.stopped = true;
+        }
+
+        // Parses every complete token of data[0, size) and returns where the unfinished last token
+        // starts (size if there is none). atEnd: no more data follows, the last token is complete.
+        template <typename T, typename Callback>
+        std::size_t scanBlock(const char* data, std::size_t size, bool atEnd, State& state, Callback& onValue)
+        {
+            constexpr std::size_t noToken { static_cast<std::size_t>(-1) };
+            std::size_t tokenStart { noToken };
+            std::uint64_t previousWhitespace { 1 }; // the block starts a new token
+
+            if (state.skipping && size > 0 && static_cast<unsigned char>(data[0]) <= ' ')
+                state.skipping = false;
+
+            // the token from tokenStart ends before data[at]
+            const auto endToken = [&](std::size_t at)
+            {
+                if (tokenStart == 0 && state.skipping)
+                    state.skipping = false;
+                else if (at - tokenStart > maxTokenLength)
+                    ++state.counts.malformed;
+                else
+                    parseToken<T>(data + tokenStart, data + at, state, onValue);
+                tokenStart = noToken;
+            };
+
+            for (std::size_t pos { 0 }; pos < size; pos += 64)
+            {
+                std::uint64_t whitespace {};
+                if (pos + 64 <= size)
+                    whitespace = whitespaceMask(data + pos);
+                else
+                {
+                    // past the end: whitespace if the input ends here (it ends the last token),
+                    // not whitespace otherwise (the last token stays open)
+                    const std::size_t left { size - pos };
+                    whitespace = atEnd ? ~std::uint64_t{ 0 } << left : 0;
+                    for (std::size_t i { 0 }; i < left; ++i)
+                        whitespace |= std::uint64_t{ static_cast<unsigned char>(data[pos + i]) <= ' ' } << i;
+                }
+
+                const std::uint64_t shifted { (whitespace << 1) | previousWhitespace };
+                previousWhitespace = whitespace >> 63;
+
+                // starts and ends alternate, so walking their union in order pairs them up
+                std::uint64_t boundaries { (~whitespace & shifted) | (whitespace & ~shifted) };
+                while (boundaries != 0)
+                {
+                    const auto bit { static_cast<unsigned>(__builtin_ctzll(boundaries)) };
+                    boundaries &= boundaries - 1;
+                    const std::size_t at { pos + bit };
+
+                    if (tokenStart == noToken)
+                    {
+                        tokenStart = at;
+                        continue;
+                    }
+
+                    endToken(at);
+                    if (state.counts.stopped)
+                        return size;
+                }
+            }
+
+            if (tokenStart == noToken || tokenStart >= size)
+                return size;
+
+            // a full last block has no bit past the end for the input's end to show as whitespace
+            if (atEnd)
+            {
+                endToken(size);
+                return size;
+            }
+
+            // too long to ever be a number: count it now and skip the rest of it in the next block
+            if (size - tokenStart > maxTokenLength)
+            {
+                if (!(tokenStart == 0 && state.skipping))
+                    ++state.counts.malformed;
+                state.skipping = true;
+                return size;
+            }
+            return tokenStart;
+        }
+
+        // Calls onValue(value) for every integer read from source, until onValue returns false.
+        // source(buffer, capacity) fills buffer with up to capacity bytes and returns how many, 0 at the end
+        template <typename T, typename Source, typename Callback>
+        Counts forEachNumberFrom(Source source, Callback onValue, std::size_t blockSize = defaultBlockSize)
+        {
+            static_assert(std::is_integral_v<T>, "NumberStream reads integers");
+
+            // room for one block plus the unfinished token carried over from the previous one
+            std::vector<char> buffer(blockSize + maxTokenLength);
+            State state {};
+            std::size_t carry { 0 };
+
+            while (true)
+            {
+                const std::size_t read { source(buffer.data() + carry, blockSize) };
+                const std::size_t size { carry + read };
+                const std::size_t rest { scanBlock<T>(buffer.data(), size, read == 0, state, onValue) };
+                if (read == 0 || state.counts.stopped)
+                    break;
+
+                carry = size - rest;
+                std::memmove(buffer.data(), buffer.data() + rest, carry);
+            }
+            return state.counts;
+        }
+    }
+
+    // Calls onValue(value) for every integer read from the file descriptor fd (0 for standard input),
+    // until onValue returns false
+    template <typename T, typename Callback>
+    Counts forEachNumber(int fd, Callback onValue, std::size_t blockSize = defaultBlockSize)
+    {
+        auto source = [fd](char* buffer, std::size_t capacity) -> std::size_t
+        {
+            while (true)
+            {
+                const ssize_t n { ::read(fd, buffer, capacity) };
+                if (n >= 0)
+                    return static_cast<std::size_t>(n);
+                if (errno != EINTR)
+                    throw std::system_error(errno, std::generic_category(), "read() failed");
+            }
+        };
+        return detail::forEachNumberFrom<T>(source, onValue, blockSize);
+    }
+
+    // From memory, fed block by block like a file
+    template <typename T, typename Callback>
+    Counts forEachNumber(std::string_view text, Callback onValue, std::size_t blockSize = defaultBlockSize)
+    {
+        auto source = [&text](char* buffer, std::size_t capacity)
+        {
+            const std::size_t n { std::min(capacity, text.size()) };
+            std::memcpy(buffer, text.data(), n);
+            text.remove_prefix(n);
+            return n;
+        };
+        return detail::forEachNumberFrom<T>(source, onValue, blockSize);
+    }
+}
+
+#endif
@@ -0,0 +1,227 @@
+// question4 for huge inputs: min/max of a stream of numbers without storing it
+// Build with: clang++ -std=c++17 -O2 -mavx2 main.cpp -o minmax
+// Run with:   ./minmax                          numbers from the keyboard, -1 or end of input to stop
+//             ./minmax numbers.txt              every number of a file
+//             ./minmax --benchmark [count]      std::cin-style reading vs NumberStream
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "NumberStream.h"
+
+// The original version from question4, used as the reference
+template <typename T>
+std::pair<std::size_t, std::size_t> findMinMaxIndices(const std::vector<T>& v)
+{
+    // Assume element 0 is the minimum and the maximum
+    std::size_t minIndex { 0 };
+    std::size_t maxIndex { 0 };
+
+    // Look through the remaining elements to see if we can find a smaller or larger element
+    for (std::size_t index { 1 }; index < v.size(); ++index)
+    {
+        if (v[index] < v[minIndex])
+            minIndex = index;
+        if (v[index] > v[maxIndex])
+            maxIndex = index;
+    }
+
+    return { minIndex, maxIndex };
+}
+
+// Simple and slow: split on whitespace with operator>>, then accept only tokens that are a whole number
+NumberStream::Counts referenceParse(const std::string& text, std::vector<int>& values)
+{
+    NumberStream::Counts counts {};
+    std::istringstream in { text };
+    std::string token {};
+    while (in >> token)
+    {
+        std::size_t used { 0 };
+        try
+        {
+            const int value { std::stoi(token, &used) };
+            if (used == token.size())
+            {
+                values.push_back(value);
+                ++counts.values;
+                continue;
+            }
+        }
+        catch (const std::logic_error&) // invalid_argument or out_of_range
+        {
+        }
+        ++counts.malformed;
+    }
+    return counts;
+}
+
+void checkParser()
+{
+    // tokens cut anywhere by the end of a block must come out the same for every block size
+    const std::string text { "  12 -7\t+5\n\n2147483647 -2147483648 2147483648 12abc x -0 7\r\n"
+        "1234567890123456789012345678901234567890123456789012345678901234567890123 8 - + 9" };
+    const std::vector<int> expected { 12, -7, 5, 2147483647, -2147483648, 0, 7, 8, 9 };
+    for (std::size_t blockSize { 1 }; blockSize < 200; ++blockSize)
+    {
+        std::vector<int> values {};
+        const auto counts { NumberStream::forEachNumber<int>(text,
+            [&](int v) { values.push_back(v); return true; }, blockSize) };
+        assert(values == expected);
+        assert(counts.values == expected.size() && counts.malformed == 6 && !counts.stopped);
+    }
+
+    // a last token of exactly 64 bytes with no newline after it ends a full block
+    const std::string longLast { "5 " + std::string(63, '0') + "7" };
+    for (std::size_t blockSize : { 1, 2, 64, 66, 1000 })
+    {
+        std::vector<int> values {};
+        const auto counts { NumberStream::forEachNumber<int>(longLast,
+            [&](int v) { values.push_back(v); return true; }, blockSize) };
+        assert((values == std::vector{ 5, 7 }) && counts.values == 2 && counts.malformed == 0);
+    }
+    std::vector<int> alone {};
+    NumberStream::forEachNumber<int>(std::string_view{ longLast }.substr(2), [&](int v) { alone.push_back(v); return true; });
+    assert(alone == std::vector{ 7 });
+
+    // the callback stops the stream, like -1 in the original
+    std::vector<int> beforeStop {};
+    const auto stopped { NumberStream::forEachNumber<int>(std::string_view{ "3 4 -1 5" },
+        [&](int v) { beforeStop.push_back(v); return v != -1; }) };
+    assert(stopped.stopped && (beforeStop == std::vector{ 3, 4, -1 }));
+
+    // random text against the reference, with whitespace runs longer than 64 bytes and long garbage
+    std::mt19937 rng { 42 };
+    const std::string pieces[] { " ", "\n", "\t", std::string(70, ' '), "-", "+", "x", "0", "1", "9",
+        "123", "-456", "99999999999", std::string(80, '7') };
+    std::uniform_int_distribution pick { 0, static_cast<int>(std::size(pieces)) - 1 };
+    for (int round { 0 }; round < 200; ++round)
+    {
+        std::string random {};
+        for (int i { 0 }; i < 300; ++i)
+            random += pieces[pick(rng)];
+
+        std::vector<int> expectedValues {};
+        const auto expectedCounts { referenceParse(random, expectedValues) };
+        for (std::size_t blockSize : { 1, 7, 64, 65, 1000, 1 << 20 })
+        {
+            std::vector<int> values {};
+            const auto counts { NumberStream::forEachNumber<int>(random,
+                [&](int v) { values.push_back(v); return true; }, blockSize) };
+            assert(values == expectedValues);
+            assert(counts.values == expectedCounts.values && counts.malformed == expectedCounts.malformed);
+        }
+    }
+
+    // RunningMinMax keeps the first occurrences, like findMinMaxIndices()
+    const std::vector v { 3, 8, 2, 5, 7, 8, 2 };
+    NumberStream::RunningMinMax<int> minMax {};
+    for (const int e : v)
+        minMax.add(e);
+    const auto [minIndex, maxIndex] { findMinMaxIndices(v) };
+    assert(minMax.minIndex() == minIndex && minMax.maxIndex() == maxIndex);
+}
+
+void printMinMax(const NumberStream::RunningMinMax<int>& minMax, const NumberStream::Counts& counts)
+{
+    if (minMax.empty())
+    {
+        std::cout << "The array has no elements\n";
+        return;
+    }
+    std::cout << "Read " << minMax.count() << " numbers (" << counts.malformed << " malformed tokens skipped)\n";
+    std::cout << "The min element has index " << minMax.minIndex() << " and value " << minMax.minValue() << '\n';
+    std::cout << "The max element has index " << minMax.maxIndex() << " and value " << minMax.maxValue() << '\n';
+}
+
+void benchmark(std::size_t count)
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+    const char* path { "minmax-benchmark.txt" };
+
+    {
+        std::mt19937 rng { 42 };
+        std::uniform_int_distribution values { -1'000'000'000, 1'000'000'000 };
+        std::ofstream out { path };
+        for (std::size_t i { 0 }; i < count; ++i)
+            out << values(rng) << ((i % 10 == 9) ? '\n' : ' ');
+    }
+
+    // the original: operator>> and push_back, then findMinMaxIndices()
+    auto start { Clock::now() };
+    std::vector<int> v {};
+    {
+        std::ifstream in { path };
+        int input {};
+        while (in >> input)
+            v.push_back(input);
+    }
+    const auto reference { findMinMaxIndices(v) };
+    const Ms referenceTime { Clock::now() - start };
+
+    start = Clock::now();
+    NumberStream::RunningMinMax<int> minMax {};
+    const int fd { ::open(path, O_RDONLY) };
+    assert(fd >= 0);
+    const auto counts { NumberStream::forEachNumber<int>(fd, [&](int value) { minMax.add(value); return true; }) };
+    ::close(fd);
+    const Ms streamTime { Clock::now() - start };
+
+    std::remove(path);
+    assert(counts.values == v.size() && counts.malformed == 0);
+    assert(minMax.minIndex() == reference.first && minMax.maxIndex() == reference.second);
+
+    std::cout << count << " numbers:\n"
+              << "  operator>> + vector: " << referenceTime.count() << " ms\n"
+              << "  NumberStream:        " << streamTime.count() << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+    checkParser();
+
+    const std::string argument { argc > 1 ? argv[1] : "" };
+    if (argument == "--benchmark")
+    {
+        benchmark(argc > 2 ? std::stoull(argv[2]) : 20'000'000);
+        return 0;
+    }
+
+    NumberStream::RunningMinMax<int> minMax {};
+    if (!argument.empty())
+    {
+        const int fd { ::open(argument.c_str(), O_RDONLY) };
+        if (fd < 0)
+        {
+            std::cerr << "Can't open " << argument << '\n';
+            return 1;
+        }
+        const auto counts { NumberStream::forEachNumber<int>(fd, [&](int value) { minMax.add(value); return true; }) };
+        ::close(fd);
+        printMinMax(minMax, counts);
+        return 0;
+    }
+
+    std::cout << "Enter numbers to add (use -1 to stop): " << std::flush;
+    const auto counts { NumberStream::forEachNumber<int>(STDIN_FILENO, [&](int value)
+    {
+        if (value == -1)
+            return false;
+        minMax.add(value);
+        return true;
+    }) };
+    printMinMax(minMax, counts);
+
+    return 0;
+}
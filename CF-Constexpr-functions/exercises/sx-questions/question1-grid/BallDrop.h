@@ -0,0 +1,127 @@
+// Ball heights for many towers and many time steps at once
+//
+// calculateBallHeight() answers one (tower, second) question per call. To fill a whole grid of
+// heights (one row of `steps` values per tower, row after row in one buffer) we note that:
+// * the distance fallen after step t does not depend on the tower: it is computed once per grid,
+//   and a row is then "tower height - fallen[t]", a plain vector subtraction (AVX2 when compiled
+//   with -mavx2, a loop the compiler can vectorize otherwise);
+// * the ball reaches the ground at t = sqrt(2 * height / gravity), so the number of steps with the
+//   ball in the air is known before the row is computed: the rest of the row is filled with 0
+//   (on the ground) without computing anything.
+// Heights on the ground are 0 instead of the negative values calculateBallHeight() returns.
+//
+// heightTable() computes the same grid at compile time when the towers are known then.
+
+#ifndef BALLDROP_H
+#define BALLDROP_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace BallDrop
+{
+	constexpr double gravity{ 9.8 };
+
+	// Same formula as calculateBallHeight(), for any time, 0 once the ball is on the ground
+	constexpr double heightAt(double towerHeight, double seconds)
+	{
+		const double distanceFallen{ (gravity * (seconds * seconds)) / 2.0 };
+		const double currentHeight{ towerHeight - distanceFallen };
+		return currentHeight > 0.0 ? currentHeight : 0.0;
+	}
+
+	// Time at which a ball dropped from towerHeight hits the ground
+	inline double impactTime(double towerHeight)
+	{
+		return towerHeight > 0.0 ? std::sqrt(2.0 * towerHeight / gravity) : 0.0;
+	}
+
+	namespace detail
+	{
+		// row[t] = towerHeight - fallen[t] for t in [0, count)
+		inline void subtractRow(double towerHeight, const double* fallen, std::size_t count, double* row)
+		{
+			std::size_t t{ 0 };
+#if defined(__AVX2__)
+			const __m256d height{ _mm256_set1_pd(towerHeight) };
+			for (; t + 8 <= count; t += 8)
+			{
+				_mm256_storeu_pd(row + t, _mm256_sub_pd(height, _mm256_loadu_pd(fallen + t)));
+				_mm256_storeu_pd(row + t + 4, _mm256_sub_pd(height, _mm256_loadu_pd(fallen + t + 4)));
+			}
+#endif
+			for (; t < count; ++t)
+				row[t] = towerHeight - fallen[t];
+		}
+
+		// Number of steps, from step 0, with the ball still in the air
+		inline std::size_t airborneSteps(double towerHeight, const std::vector<double>& fallen, double dt)
+		{
+			const std::size_t steps{ fallen.size() };
+			if (!(towerHeight > 0.0))
+				return 0;
+
+			// the analytic answer, then corrected by at most a step or two of rounding
+			const double last{ std::floor(impactTime(towerHeight) / dt) };
+			std::size_t airborne{ last < static_cast<double>(steps) ? static_cast<std::size_t>(last) + 1 : steps };
+			while (airborne > 0 && !(towerHeight - fallen[airborne - 1] > 0.0))
+				--airborne;
+			while (airborne < steps && towerHeight - fallen[airborne] > 0.0)
+				++airborne;
+			return airborne;
+		}
+	}
+
+	// heights[tower * steps + t]: height of the ball dropped from towers[tower] after t * dt seconds
+	inline void computeHeights(const double* towers, std::size_t towerCount, std::size_t steps, double dt, double* heights)
+	{
+		std::vector<double> fallen(steps);
+		for (std::size_t t{ 0 }; t < steps; ++t)
+		{
+			const double seconds{ static_cast<double>(t) * dt };
+			fallen[t] = (gravity * (seconds * seconds)) / 2.0;
+		}
+
+		for (std::size_t tower{ 0 }; tower < towerCount; ++tower)
+		{
+			double* row{ heights + tower * steps };
+			const std::size_t airborne{ detail::airborneSteps(towers[tower], fallen, dt) };
+			detail::subtractRow(towers[tower], fallen.data(), airborne, row);
+			std::fill(row + airborne, row + steps, 0.0);
+		}
+	}
+
+	inline std::vector<double> computeHeights(const std::vector<double>& towers, std::size_t steps, double dt = 1.0)
+	{
+		std::vector<double> heights(towers.size() * steps);
+		computeHeights(towers.data(), towers.size(), steps, dt, heights.data());
+		return heights;
+	}
+
+	// The same grid computed by the compiler: heightTable<Steps>(towers)[tower * Steps + t]
+	template <std::size_t Steps, std::size_t Towers>
+	constexpr std::array<double, Towers * Steps> heightTable(const std::array<double, Towers>& towers, double dt = 1.0)
+	{
+		std::array<double, Towers * Steps> heights{};
+		for (std::size_t tower{ 0 }; tower < Towers; ++tower)
+		{
+			for (std::size_t t{ 0 }; t < Steps; ++t)
+			{
+				const double height{ heightAt(towers[tower], static_cast<double>(t) * dt) };
+				if (height == 0.0)
+					break; // on the ground: the rest of the row stays 0
+				heights[tower * Steps + t] = height;
+			}
+		}
+		return heights;
+	}
+}
+
+#endif
@@ -0,0 +1,152 @@
+// calculateBallHeight() one call at a time vs BallDrop height grids
+// Build with: clang++ -std=c++17 -O2 -mavx2 main.cpp -o balldrop
+// Run with:   ./balldrop                          the six heights of question 1
+//             ./balldrop --benchmark [towers]     one height at a time vs the grid (default 10'000
+//                                                 towers x 1000 steps: 2 x 80 MB of heights)
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "BallDrop.h"
+
+// The original, used as the reference
+constexpr double calculateBallHeight(double towerHeight, int seconds)
+{
+	constexpr double gravity{ 9.8 };
+
+	// Using formula: [ s = u * t + (a * t^2) / 2 ], here u(initial velocity) = 0
+	const double distanceFallen{ (gravity * (seconds * seconds)) / 2.0 };
+	const double currentHeight{ towerHeight - distanceFallen };
+
+	return currentHeight;
+}
+
+// Not constexpr because I/O can only be done at runtime
+//
+// gets tower height from user and returns it
+double getTowerHeight()
+{
+	std::cout << "Enter the height of the tower in meters: ";
+	double towerHeight{};
+	std::cin >> towerHeight;
+	return towerHeight;
+}
+
+// Prints ball height above ground
+void printBallHeight(double ballHeight, int seconds)
+{
+	if (ballHeight > 0.0)
+		std::cout << "At " << seconds << " seconds, the ball is at height: " << ballHeight << " meters\n";
+	else
+		std::cout << "At " << seconds << " seconds, the ball is on the ground.\n";
+}
+
+// Known at compile time: three towers, heights after 0..5 seconds
+constexpr std::array<double, 3> knownTowers{ 100.0, 20.0, 0.0 };
+constexpr auto knownHeights{ BallDrop::heightTable<6>(knownTowers) };
+
+static_assert(knownHeights[0] == calculateBallHeight(100.0, 0));
+static_assert(knownHeights[4] == calculateBallHeight(100.0, 4));
+static_assert(knownHeights[5] == 0.0); // 100 - 122.5 < 0: on the ground
+static_assert(knownHeights[6 + 1] == calculateBallHeight(20.0, 1));
+static_assert(knownHeights[6 + 2] > 0.0 && knownHeights[6 + 3] == 0.0 && knownHeights[6 + 5] == 0.0);
+static_assert(knownHeights[12] == 0.0);
+
+void checkGrid()
+{
+	std::mt19937 rng{ 42 };
+	std::uniform_real_distribution<double> height{ -10.0, 2000.0 };
+	std::vector<double> towers(1000);
+	for (auto& tower : towers)
+		tower = height(rng);
+	// exactly on the ground at a step: 4.9 * 3^2 = 44.1
+	towers.push_back(BallDrop::gravity * 9 / 2.0);
+	towers.push_back(0.0);
+
+	constexpr std::size_t steps{ 37 };
+	const auto heights{ BallDrop::computeHeights(towers, steps) };
+	for (std::size_t tower{ 0 }; tower < towers.size(); ++tower)
+	{
+		for (std::size_t t{ 0 }; t < steps; ++t)
+		{
+			const double expected{ calculateBallHeight(towers[tower], static_cast<int>(t)) };
+			assert(heights[tower * steps + t] == (expected > 0.0 ? expected : 0.0));
+		}
+	}
+
+	// the analytic impact time agrees with the grid at any resolution
+	const double dt{ 0.013 };
+	const auto fine{ BallDrop::computeHeights(towers, 5000, dt) };
+	for (std::size_t tower{ 0 }; tower < towers.size(); ++tower)
+		for (std::size_t t{ 0 }; t < 5000; ++t)
+			assert(fine[tower * 5000 + t] == BallDrop::heightAt(towers[tower], static_cast<double>(t) * dt));
+
+	for (std::size_t i{ 0 }; i < knownTowers.size() * 6; ++i)
+		assert(knownHeights[i] == BallDrop::computeHeights({ knownTowers.begin(), knownTowers.end() }, 6)[i]);
+}
+
+void benchmark(std::size_t towerCount)
+{
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::duration<double, std::milli>;
+
+	// towers up to 1 km, 1000 steps of 0.05 s: most balls land long before the end
+	constexpr std::size_t steps{ 1000 };
+	constexpr double dt{ 0.05 };
+
+	std::mt19937 rng{ 42 };
+	std::uniform_real_distribution<double> height{ 0.0, 1000.0 };
+	std::vector<double> towers(towerCount);
+	for (auto& tower : towers)
+		tower = height(rng);
+
+	// one call per (tower, step), as printCalculatedBallHeight() does
+	std::vector<double> reference(towerCount * steps);
+	auto start{ Clock::now() };
+	for (std::size_t tower{ 0 }; tower < towerCount; ++tower)
+	{
+		for (std::size_t t{ 0 }; t < steps; ++t)
+		{
+			const double seconds{ static_cast<double>(t) * dt };
+			const double ballHeight{ towers[tower] - (9.8 * (seconds * seconds)) / 2.0 };
+			reference[tower * steps + t] = ballHeight > 0.0 ? ballHeight : 0.0;
+		}
+	}
+	const Ms referenceTime{ Clock::now() - start };
+
+	std::vector<double> heights(towerCount * steps);
+	start = Clock::now();
+	BallDrop::computeHeights(towers.data(), towerCount, steps, dt, heights.data());
+	const Ms gridTime{ Clock::now() - start };
+
+	assert(heights == reference);
+	std::cout << towerCount << " towers x " << steps << " steps:\n"
+		<< "  one height at a time: " << referenceTime.count() << " ms\n"
+		<< "  BallDrop grid:        " << gridTime.count() << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+	checkGrid();
+
+	if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+	{
+		const long towers{ argc > 2 ? std::strtol(argv[2], nullptr, 10) : 10'000 };
+		benchmark(static_cast<std::size_t>(towers > 0 ? towers : 1));
+		return 0;
+	}
+
+	const double towerHeight{ getTowerHeight() };
+
+	// the six heights of the original as one row of a grid
+	const auto heights{ BallDrop::computeHeights({ towerHeight }, 6) };
+	for (int seconds{ 0 }; seconds < 6; ++seconds)
+		printBallHeight(heights[static_cast<std::size_t>(seconds)], seconds);
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+// FlagColumn<Enum>: the FlagSet of millions of articles, stored as bit planes
+//
+// A std::vector<FlagSet> keeps the flags of one article together, so a query such as
+// "favorited and not deleted" reads every article and tests it. FlagColumn turns the layout
+// around: one bit plane per flag, where bit i of the plane is the flag of article i. A query then
+// combines 64 articles per operation (plane words ANDed, or ANDed with the complement) and counts
+// them with one popcount per word. Only the planes of the flags in the query are read.
+
+#ifndef FLAGCOLUMN_H
+#define FLAGCOLUMN_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FlagSet.h"
+
+template <typename Enum, std::size_t Count = static_cast<std::size_t>(Enum::count)>
+class FlagColumn
+{
+public:
+    using Flags = FlagSet<Enum, Count>;
+
+private:
+    static constexpr std::size_t wordBits { 64 };
+
+    std::size_t m_size {};
+    std::vector<std::uint64_t> m_planes[Count] {};
+
+    static std::size_t wordCount(std::size_t rows) { return (rows + wordBits - 1) / wordBits; }
+
+    // The planes a query reads, and whether each one is complemented ("without" flags)
+    struct Query
+    {
+        const std::uint64_t* planes[Count] {};
+        std::uint64_t flips[Count] {};
+        std::size_t size {};
+        bool empty {};
+    };
+
+    Query makeQuery(Flags with, Flags without) const
+    {
+        // a flag in both sets can't match anything
+        if ((with & without).any())
+            return Query{ {}, {}, 0, true };
+
+        Query query {};
+        for (std::size_t f { 0 }; f < Count; ++f)
+        {
+            const auto flag { static_cast<Enum>(f) };
+            if (with.test(flag) || without.test(flag))
+            {
+                query.planes[query.size] = m_planes[f].data();
+                query.flips[query.size] = with.test(flag) ? 0 : ~std::uint64_t{ 0 };
+                ++query.size;
+            }
+        }
+        return query;
+    }
+
+    // Word w of the rows matching the query
+    std::uint64_t matchWord(const Query& query, std::size_t w) const
+    {
+        std::uint64_t match { query.empty ? 0 : ~std::uint64_t{ 0 } };
+        for (std::size_t k { 0 }; k < query.size; ++k)
+            match &= query.planes[k][w] ^ query.flips[k];
+
+        // the rows past size() in the last word don't exist
+        const std::size_t rowsInWord { m_size - w * wordBits };
+        if (rowsInWord < wordBits)
+            match &= (std::uint64_t{ 1 } << rowsInWord) - 1;
+        return match;
+    }
+
+public:
+    FlagColumn() = default;
+
+    explicit FlagColumn(std::size_t rows)
+    {
+        resize(rows);
+    }
+
+    std::size_t size() const { return m_size; }
+
+    // New rows have no flag set
+    void resize(std::size_t rows)
+    {
+        // clear the bits of the rows dropped from the last word, so they don't come back
+        for (auto& plane : m_planes)
+        {
+            if (rows < m_size && rows % wordBits != 0)
+                plane[rows / wordBits] &= (std::uint64_t{ 1 } << (rows % wordBits)) - 1;
+            plane.resize(wordCount(rows), 0);
+        }
+        m_size = rows;
+    }
+
+    void push_back(Flags flags)
+    {
+        resize(m_size + 1);
+        set(m_size - 1, flags);
+    }
+
+    Flags get(std::size_t row) const
+    {
+        assert(row < m_size && "FlagColumn::get(): row out of range");
+        std::uint64_t bits { 0 };
+        for (std::size_t f { 0 }; f < Count; ++f)
+            bits |= ((m_planes[f][row / wordBits] >> (row % wordBits)) & 1) << f;
+        return Flags::fromBits(bits);
+    }
+
+    void set(std::size_t row, Flags flags)
+    {
+        for (std::size_t f { 0 }; f < Count; ++f)
+            set(row, static_cast<Enum>(f), flags.test(static_cast<Enum>(f)));
+    }
+
+    void set(std::size_t row, Enum flag, bool value = true)
+    {
+        assert(row < m_size && "FlagColumn::set(): row out of range");
+        std::uint64_t& word { m_planes[static_cast<std::size_t>(flag)][row / wordBits] };
+        const std::uint64_t bit { std::uint64_t{ 1 } << (row % wordBits) };
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    bool test(std::size_t row, Enum flag) const
+    {
+        assert(row < m_size && "FlagColumn::test(): row out of range");
+        return (m_planes[static_cast<std::size_t>(flag)][row / wordBits] >> (row % wordBits)) & 1;
+    }
+
+    // Number of rows with every flag of with set and every flag of without clear
+    std::size_t count(Flags with, Flags without = {}) const
+    {
+        const Query query { makeQuery(with, without) };
+        std::size_t total { 0 };
+        for (std::size_t w { 0 }; w < wordCount(m_size); ++w)
+            total += static_cast<std::size_t>(__builtin_popcountll(matchWord(query, w)));
+        return total;
+    }
+
+    // The matching rows, in order
+    std::vector<std::size_t> select(Flags with, Flags without = {}) const
+    {
+        const Query query { makeQuery(with, without) };
+        std::vector<std::size_t> rows {};
+        for (std::size_t w { 0 }; w < wordCount(m_size); ++w)
+        {
+            for (std::uint64_t match { matchWord(query, w) }; match != 0; match &= match - 1)
+                rows.push_back(w * wordBits + static_cast<std::size_t>(__builtin_ctzll(match)));
+        }
+        return rows;
+    }
+
+    // Sets (or clears) flag on every matching row, 64 rows at a time
+    void assign(Enum flag, bool value, Flags with, Flags without = {})
+    {
+        const Query query { makeQuery(with, without) };
+        std::vector<std::uint64_t>& plane { m_planes[static_cast<std::size_t>(flag)] };
+        for (std::size_t w { 0 }; w < wordCount(m_size); ++w)
+        {
+            const std::uint64_t match { matchWord(query, w) };
+            plane[w] = value ? (plane[w] | match) : (plane[w] & ~match);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+// FlagSet<Enum>: the option_* bit masks of the article exercise with a type
+//
+// Instead of loose std::uint8_t constants combined by hand, the options are the enumerators of a
+// scoped enum, numbered from 0, with a last enumerator `count`:
+//
+//     enum class ArticleOption { viewed, edited, favorited, shared, deleted, count };
+//     FlagSet<ArticleOption> flags { ArticleOption::favorited };
+//     flags.set(ArticleOption::viewed);
+//
+// A FlagSet of one enum can't be mixed up with the flags of another one or with a plain integer.
+// It is stored in the smallest unsigned integer with enough bits, and every operation is constexpr.
+
+#ifndef FLAGSET_H
+#define FLAGSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+namespace FlagDetail
+{
+    // smallest unsigned type with at least Bits bits
+    template <std::size_t Bits>
+    using Storage = std::conditional_t<(Bits <= 8), std::uint8_t,
+                    std::conditional_t<(Bits <= 16), std::uint16_t,
+                    std::conditional_t<(Bits <= 32), std::uint32_t, std::uint64_t>>>;
+
+    constexpr int popcount(std::uint64_t bits)
+    {
+        int count { 0 };
+        for (; bits != 0; bits &= bits - 1)
+            ++count;
+        return count;
+    }
+}
+
+template <typename Enum, std::size_t Count = static_cast<std::size_t>(Enum::count)>
+class FlagSet
+{
+    static_assert(std::is_enum_v<Enum>, "FlagSet needs an enum");
+    static_assert(Count >= 1 && Count <= 64, "FlagSet holds 1 to 64 flags");
+
+public:
+    using Bits = FlagDetail::Storage<Count>;
+
+    static constexpr std::size_t size() { return Count; }
+
+    // every valid flag set
+    static constexpr Bits mask { static_cast<Bits>(Count == 64 ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << Count) - 1) };
+
+private:
+    Bits m_bits {};
+
+    static constexpr Bits bit(Enum flag)
+    {
+        return static_cast<Bits>(Bits{ 1 } << static_cast<std::size_t>(flag));
+    }
+
+public:
+    constexpr FlagSet() = default;
+
+    constexpr FlagSet(std::initializer_list<Enum> flags)
+    {
+        for (const Enum flag : flags)
+            m_bits = static_cast<Bits>(m_bits | bit(flag));
+    }
+
+    // the raw bits, for storage; bits past Count are dropped
+    static constexpr FlagSet fromBits(std::uint64_t bits)
+    {
+        FlagSet flags {};
+        flags.m_bits = static_cast<Bits>(bits & mask);
+        return flags;
+    }
+
+    constexpr Bits bits() const { return m_bits; }
+
+    constexpr bool test(Enum flag) const { return (m_bits & bit(flag)) != 0; }
+    constexpr bool any() const { return m_bits != 0; }
+    constexpr bool none() const { return m_bits == 0; }
+    constexpr bool all() const { return m_bits == mask; }
+    constexpr int count() const { return FlagDetail::popcount(m_bits); }
+
+    // true when every flag of other is set here too
+    constexpr bool contains(FlagSet other) const { return (m_bits & other.m_bits) == other.m_bits; }
+
+    constexpr FlagSet& set(Enum flag, bool value = true)
+    {
+        m_bits = static_cast<Bits>(value ? (m_bits | bit(flag)) : (m_bits & ~bit(flag)));
+        return *this;
+    }
+
+    constexpr FlagSet& reset(Enum flag) { return set(flag, false); }
+
+    constexpr FlagSet& flip(Enum flag)
+    {
+        m_bits = static_cast<Bits>(m_bits ^ bit(flag));
+        return *this;
+    }
+
+    constexpr FlagSet& operator|=(FlagSet other) { m_bits = static_cast<Bits>(m_bits | other.m_bits); return *this; }
+    constexpr FlagSet& operator&=(FlagSet other) { m_bits = static_cast<Bits>(m_bits & other.m_bits); return *this; }
+    constexpr FlagSet& operator^=(FlagSet other) { m_bits = static_cast<Bits>(m_bits ^ other.m_bits); return *this; }
+
+    friend constexpr FlagSet operator|(FlagSet a, FlagSet b) { return a |= b; }
+    friend constexpr FlagSet operator&(FlagSet a, FlagSet b) { return a &= b; }
+    friend constexpr FlagSet operator^(FlagSet a, FlagSet b) { return a ^= b; }
+    friend constexpr FlagSet operator~(FlagSet a) { return fromBits(static_cast<Bits>(~a.m_bits)); }
+
+    friend constexpr bool operator==(FlagSet a, FlagSet b) { return a.m_bits == b.m_bits; }
+    friend constexpr bool operator!=(FlagSet a, FlagSet b) { return a.m_bits != b.m_bits; }
+};
+
+#endif
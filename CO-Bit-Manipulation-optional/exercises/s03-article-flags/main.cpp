@@ -0,0 +1,129 @@
+// The article flags of s03 with FlagSet, and the flags of millions of articles with FlagColumn
+// Build with: clang++ -std=c++17 -O2 -mpopcnt main.cpp -o flags
+
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "FlagColumn.h"
+#include "FlagSet.h"
+
+enum class ArticleOption
+{
+    viewed,
+    edited,
+    favorited,
+    shared,
+    deleted,
+    count,
+};
+
+using ArticleFlags = FlagSet<ArticleOption>;
+
+// Everything is constexpr, and the bits are the ones of the option_* constants
+static_assert(sizeof(ArticleFlags) == sizeof(std::uint8_t));
+static_assert(ArticleFlags{ ArticleOption::viewed }.bits() == 0x01);
+static_assert(ArticleFlags{ ArticleOption::deleted }.bits() == 0x10);
+static_assert(ArticleFlags{ ArticleOption::favorited }.set(ArticleOption::viewed).bits() == 0x05);
+static_assert((~ArticleFlags{}).all() && (~ArticleFlags{}).count() == 5 && (~ArticleFlags{}).bits() == 0x1F);
+static_assert(ArticleFlags{ ArticleOption::shared, ArticleOption::edited }.contains(ArticleFlags{ ArticleOption::edited }));
+static_assert(ArticleFlags::fromBits(0xFF) == ~ArticleFlags{});
+static_assert(!ArticleFlags{ ArticleOption::shared }.flip(ArticleOption::shared).any());
+
+void checkColumn()
+{
+    std::mt19937 rng { 42 };
+    std::vector<ArticleFlags> articles(1000);
+    for (auto& article : articles)
+        article = ArticleFlags::fromBits(rng());
+
+    FlagColumn<ArticleOption> column {};
+    for (const auto article : articles)
+        column.push_back(article);
+    assert(column.size() == articles.size());
+
+    const ArticleFlags favorited { ArticleOption::favorited };
+    const ArticleFlags deleted { ArticleOption::deleted };
+    std::vector<std::size_t> expected {};
+    for (std::size_t i { 0 }; i < articles.size(); ++i)
+    {
+        assert(column.get(i) == articles[i]);
+        if (articles[i].contains(favorited) && !articles[i].test(ArticleOption::deleted))
+            expected.push_back(i);
+    }
+    assert(column.select(favorited, deleted) == expected);
+    assert(column.count(favorited, deleted) == expected.size());
+    assert(column.count({}) == articles.size());
+    assert(column.count(favorited, favorited) == 0);
+
+    // un-favorite the deleted articles
+    column.assign(ArticleOption::favorited, false, deleted);
+    assert(column.count(favorited | deleted) == 0);
+    assert(column.count(favorited) == expected.size());
+
+    // shrinking drops the flags of the removed rows
+    column.resize(10);
+    column.resize(100);
+    for (std::size_t i { 10 }; i < 100; ++i)
+        assert(column.get(i).none());
+}
+
+void benchmark()
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    constexpr std::size_t articles { 10'000'000 };
+    std::mt19937 rng { 42 };
+    std::vector<std::uint8_t> bytes(articles);
+    FlagColumn<ArticleOption> column { articles };
+    for (std::size_t i { 0 }; i < articles; ++i)
+    {
+        bytes[i] = static_cast<std::uint8_t>(rng() & 0x1F);
+        column.set(i, ArticleFlags::fromBits(bytes[i]));
+    }
+
+    // "favorited and not deleted", one std::uint8_t per article as in the exercise
+    constexpr std::uint8_t option_favorited { 0x04 };
+    constexpr std::uint8_t option_deleted { 0x10 };
+    auto start { Clock::now() };
+    std::size_t expected { 0 };
+    for (const std::uint8_t flags : bytes)
+        expected += (flags & (option_favorited | option_deleted)) == option_favorited;
+    const Ms byteTime { Clock::now() - start };
+
+    start = Clock::now();
+    const std::size_t count { column.count({ ArticleOption::favorited }, { ArticleOption::deleted }) };
+    const Ms columnTime { Clock::now() - start };
+
+    assert(count == expected);
+    std::cout << articles << " articles, " << count << " favorited and not deleted:\n"
+              << "  one byte per article: " << byteTime.count() << " ms\n"
+              << "  FlagColumn:           " << columnTime.count() << " ms\n";
+}
+
+int main()
+{
+    checkColumn();
+
+    ArticleFlags myArticleFlags{ ArticleOption::favorited };
+
+    // a) Set article as viewed
+    myArticleFlags.set(ArticleOption::viewed);
+    std::cout << std::bitset<8>{ myArticleFlags.bits() } << '\n';
+
+    // b) Check if the article was deleted
+    bool articleDeleted { myArticleFlags.test(ArticleOption::deleted) };
+    std::cout << articleDeleted << '\n';
+
+    // c) Clear the article as a favourite
+    myArticleFlags.reset(ArticleOption::favorited);
+    std::cout << std::bitset<8>{ myArticleFlags.bits() } << '\n';
+
+    benchmark();
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+// FlagIndex<Enum>: for every flag, the compressed set of the article ids that have it
+//
+// FlagColumn keeps one bit per article and flag, so it costs the same for a flag almost nobody
+// has as for one almost everybody has, and every query reads the whole planes. FlagIndex keeps a
+// RoaringBitmap per flag instead: rare flags take a few bytes per article that has them, ranges of
+// articles sharing a flag take a few bytes per range, and a query only touches the chunks of ids
+// where its flags are present. The ids of all the articles are kept too, for queries made only of
+// "without" flags.
+
+#ifndef FLAGINDEX_H
+#define FLAGINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FlagSet.h"
+#include "RoaringBitmap.h"
+
+template <typename Enum, std::size_t Count = static_cast<std::size_t>(Enum::count)>
+class FlagIndex
+{
+public:
+    using Flags = FlagSet<Enum, Count>;
+
+private:
+    RoaringBitmap m_all {};
+    RoaringBitmap m_flags[Count] {};
+
+public:
+    // Adding the ids in increasing order is the fast path
+    void add(std::uint32_t id, Flags flags)
+    {
+        m_all.add(id);
+        for (std::size_t f { 0 }; f < Count; ++f)
+        {
+            if (flags.test(static_cast<Enum>(f)))
+                m_flags[f].add(id);
+        }
+    }
+
+    // Adds the articles [begin, end), all with the same flags
+    void addRange(std::uint32_t begin, std::uint32_t end, Flags flags)
+    {
+        m_all.addRange(begin, end);
+        for (std::size_t f { 0 }; f < Count; ++f)
+        {
+            if (flags.test(static_cast<Enum>(f)))
+                m_flags[f].addRange(begin, end);
+        }
+    }
+
+    const RoaringBitmap& articles() const { return m_all; }
+    const RoaringBitmap& articles(Enum flag) const { return m_flags[static_cast<std::size_t>(flag)]; }
+
+    std::uint64_t size() const { return m_all.cardinality(); }
+
+    Flags get(std::uint32_t id) const
+    {
+        Flags flags {};
+        for (std::size_t f { 0 }; f < Count; ++f)
+            flags.set(static_cast<Enum>(f), m_flags[f].contains(id));
+        return flags;
+    }
+
+    // The articles with every flag of with set and every flag of without clear
+    RoaringBitmap select(Flags with, Flags without = {}) const
+    {
+        // a flag in both sets can't match anything
+        if ((with & without).any())
+            return {};
+
+        // intersect the smallest sets first, so the partial results stay small (insertion sort: a handful of flags)
+        std::size_t order[Count] {};
+        std::size_t withCount { 0 };
+        for (std::size_t f { 0 }; f < Count; ++f)
+        {
+            if (!with.test(static_cast<Enum>(f)))
+                continue;
+            std::size_t k { withCount++ };
+            for (; k > 0 && m_flags[order[k - 1]].cardinality() > m_flags[f].cardinality(); --k)
+                order[k] = order[k - 1];
+            order[k] = f;
+        }
+
+        RoaringBitmap result { withCount == 0 ? m_all : m_flags[order[0]] };
+        for (std::size_t k { 1 }; k < withCount && !result.empty(); ++k)
+            result = result & m_flags[order[k]];
+        for (std::size_t f { 0 }; f < Count && !result.empty(); ++f)
+        {
+            if (without.test(static_cast<Enum>(f)))
+                result = andNot(result, m_flags[f]);
+        }
+        return result;
+    }
+
+    std::uint64_t count(Flags with, Flags without = {}) const
+    {
+        // two flags and nothing excluded: count the intersection without building it
+        if (without.none() && with.count() == 2)
+        {
+            const RoaringBitmap* pair[2] {};
+            std::size_t found { 0 };
+            for (std::size_t f { 0 }; f < Count; ++f)
+            {
+                if (with.test(static_cast<Enum>(f)))
+                    pair[found++] = &m_flags[f];
+            }
+            return andCardinality(*pair[0], *pair[1]);
+        }
+        return select(with, without).cardinality();
+    }
+
+    // Compresses the ranges of articles sharing a flag; call once the index is built
+    void runOptimize()
+    {
+        m_all.runOptimize();
+        for (auto& flag : m_flags)
+            flag.runOptimize();
+    }
+
+    std::size_t sizeInBytes() const
+    {
+        std::size_t bytes { m_all.sizeInBytes() };
+        for (const auto& flag : m_flags)
+            bytes += flag.sizeInBytes();
+        return bytes;
+    }
+};
+
+#endif
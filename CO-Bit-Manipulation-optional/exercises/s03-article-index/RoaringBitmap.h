@@ -0,0 +1,520 @@
+// RoaringBitmap: a compressed set of 32-bit ids (article ids), in the style of Roaring bitmaps
+//
+// The ids are split by their high 16 bits into chunks of 65536. Each chunk that holds at least
+// one id gets a container with the low 16 bits, in whichever form is smallest:
+// * array:  the sorted ids, 2 bytes each, for chunks with at most 4096 ids;
+// * bitmap: 65536 bits (8 KiB), for denser chunks;
+// * run:    sorted (start, length) pairs, 4 bytes each, for chunks made of long ranges
+//           (only after runOptimize()).
+// AND, OR and AND NOT walk the two sorted chunk lists together and combine the containers with
+// the cheapest method for their pair of forms: merging arrays, testing the ids of an array
+// against the other container, or combining 64 ids per word operation on bitmaps.
+
+#ifndef ROARINGBITMAP_H
+#define ROARINGBITMAP_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RoaringBitmap
+{
+private:
+    static constexpr std::size_t chunkWords { 65536 / 64 };
+    static constexpr std::size_t arrayLimit { 4096 }; // an array of more ids is larger than a bitmap
+
+    using Words = std::array<std::uint64_t, chunkWords>;
+
+    struct Run
+    {
+        std::uint16_t start {};
+        std::uint16_t length {}; // ids start to start + length, both included
+    };
+
+    enum class Type
+    {
+        array,
+        bitmap,
+        run,
+    };
+
+    struct Container
+    {
+        Type type { Type::array };
+        std::uint32_t cardinality {};
+        std::vector<std::uint16_t> array {};
+        std::vector<std::uint64_t> bitmap {}; // chunkWords words when type is bitmap
+        std::vector<Run> runs {};
+
+        bool contains(std::uint16_t low) const
+        {
+            switch (type)
+            {
+                case Type::array: return std::binary_search(array.begin(), array.end(), low);
+                case Type::bitmap: return (bitmap[low / 64] >> (low % 64)) & 1;
+                case Type::run:
+                {
+                    // last run starting at or before low
+                    auto it { std::upper_bound(runs.begin(), runs.end(), low,
+                        [](std::uint16_t value, const Run& run) { return value < run.start; }) };
+                    if (it == runs.begin())
+                        return false;
+                    --it;
+                    return low - it->start <= it->length;
+                }
+            }
+            return false;
+        }
+
+        // The ids as a bitmap: the container's own words, or scratch filled with them
+        const std::uint64_t* words(Words& scratch) const
+        {
+            if (type == Type::bitmap)
+                return bitmap.data();
+
+            scratch.fill(0);
+            if (type == Type::array)
+            {
+                for (const std::uint16_t low : array)
+                    scratch[low / 64] |= std::uint64_t{ 1 } << (low % 64);
+            }
+            else
+            {
+                for (const Run& run : runs)
+                    setRange(scratch.data(), run.start, std::uint32_t{ run.start } + run.length + 1);
+            }
+            return scratch.data();
+        }
+
+        void toBitmap()
+        {
+            Words scratch {};
+            const std::uint64_t* source { words(scratch) };
+            bitmap.assign(source, source + chunkWords);
+            type = Type::bitmap;
+            array.clear();
+            array.shrink_to_fit();
+            runs.clear();
+            runs.shrink_to_fit();
+        }
+
+        void add(std::uint16_t low)
+        {
+            if (type == Type::run)
+            {
+                Run& last { runs.back() };
+                if (low == std::uint32_t{ last.start } + last.length + 1)
+                {
+                    ++last.length;
+                    ++cardinality;
+                    return;
+                }
+                if (contains(low))
+                    return;
+                toBitmap();
+            }
+
+            if (type == Type::array)
+            {
+                if (array.empty() || low > array.back())
+                    array.push_back(low); // ids added in order: the common case
+                else
+                {
+                    const auto it { std::lower_bound(array.begin(), array.end(), low) };
+                    if (it != array.end() && *it == low)
+                        return;
+                    array.insert(it, low);
+                }
+                if (++cardinality > arrayLimit)
+                    toBitmap();
+                return;
+            }
+
+            std::uint64_t& word { bitmap[low / 64] };
+            const std::uint64_t bit { std::uint64_t{ 1 } << (low % 64) };
+            cardinality += (word & bit) == 0;
+            word |= bit;
+        }
+
+        std::size_t sizeInBytes() const
+        {
+            return array.capacity() * sizeof(std::uint16_t) + bitmap.capacity() * sizeof(std::uint64_t)
+                + runs.capacity() * sizeof(Run);
+        }
+    };
+
+    std::vector<std::uint16_t> m_keys {}; // high 16 bits of the ids of each container, sorted
+    std::vector<Container> m_containers {};
+
+    static void setRange(std::uint64_t* words, std::uint32_t begin, std::uint32_t end)
+    {
+        for (std::uint32_t i { begin }; i < end; )
+        {
+            const std::uint32_t bit { i % 64 };
+            const std::uint32_t count { std::min(64 - bit, end - i) };
+            const std::uint64_t mask { count == 64 ? ~std::uint64_t{ 0 } : ((std::uint64_t{ 1 } << count) - 1) << bit };
+            words[i / 64] |= mask;
+            i += count;
+        }
+    }
+
+    static int popcount(std::uint64_t word) { return __builtin_popcountll(word); }
+
+    // A container made from bitmap words: an array when that is smaller
+    static Container fromWords(const std::uint64_t* words, std::uint32_t cardinality)
+    {
+        Container result {};
+        result.cardinality = cardinality;
+        if (cardinality <= arrayLimit)
+        {
+            result.type = Type::array;
+            result.array.reserve(cardinality);
+            for (std::size_t w { 0 }; w < chunkWords; ++w)
+                for (std::uint64_t word { words[w] }; word != 0; word &= word - 1)
+                    result.array.push_back(static_cast<std::uint16_t>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))));
+        }
+        else
+        {
+            result.type = Type::bitmap;
+            result.bitmap.assign(words, words + chunkWords);
+        }
+        return result;
+    }
+
+    static Container fromArray(std::vector<std::uint16_t>&& ids)
+    {
+        Container result {};
+        result.cardinality = static_cast<std::uint32_t>(ids.size());
+        result.array = std::move(ids);
+        if (result.cardinality > arrayLimit)
+            result.toBitmap();
+        return result;
+    }
+
+    enum class Operation
+    {
+        intersection,
+        union_,
+        difference,
+    };
+
+    static Container combine(const Container& a, const Container& b, Operation operation)
+    {
+        // Sorted arrays: merge them
+        if (a.type == Type::array && b.type == Type::array)
+        {
+            std::vector<std::uint16_t> ids {};
+            switch (operation)
+            {
+                case Operation::intersection:
+                    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(ids));
+                    break;
+                case Operation::union_:
+                    std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(ids));
+                    break;
+                case Operation::difference:
+                    std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), std::back_inserter(ids));
+                    break;
+            }
+            return fromArray(std::move(ids));
+        }
+
+        // A small array against anything else: test each of its ids
+        if (a.type == Type::array && operation != Operation::union_)
+        {
+            const bool keepIfInB { operation == Operation::intersection };
+            std::vector<std::uint16_t> ids {};
+            for (const std::uint16_t low : a.array)
+                if (b.contains(low) == keepIfInB)
+                    ids.push_back(low);
+            return fromArray(std::move(ids));
+        }
+        if (b.type == Type::array && operation == Operation::intersection)
+            return combine(b, a, operation);
+
+        // Otherwise as bitmaps, 64 ids per operation
+        Words scratchA {};
+        Words scratchB {};
+        const std::uint64_t* wa { a.words(scratchA) };
+        const std::uint64_t* wb { b.words(scratchB) };
+        Words result {};
+        std::uint32_t cardinality { 0 };
+        for (std::size_t w { 0 }; w < chunkWords; ++w)
+        {
+            std::uint64_t word {};
+            switch (operation)
+            {
+                case Operation::intersection: word = wa[w] & wb[w]; break;
+                case Operation::union_: word = wa[w] | wb[w]; break;
+                case Operation::difference: word = wa[w] & ~wb[w]; break;
+            }
+            result[w] = word;
+            cardinality += static_cast<std::uint32_t>(popcount(word));
+        }
+        return fromWords(result.data(), cardinality);
+    }
+
+    static std::uint64_t intersectionCardinality(const Container& a, const Container& b)
+    {
+        if (a.type == Type::array && b.type == Type::array)
+        {
+            std::uint64_t count { 0 };
+            auto i { a.array.begin() };
+            auto j { b.array.begin() };
+            while (i != a.array.end() && j != b.array.end())
+            {
+                if (*i < *j)
+                    ++i;
+                else if (*j < *i)
+                    ++j;
+                else
+                {
+                    ++count;
+                    ++i;
+                    ++j;
+                }
+            }
+            return count;
+        }
+        if (a.type == Type::array || b.type == Type::array)
+        {
+            const Container& small { a.type == Type::array ? a : b };
+            const Container& other { a.type == Type::array ? b : a };
+            return static_cast<std::uint64_t>(std::count_if(small.array.begin(), small.array.end(),
+                [&other](std::uint16_t low) { return other.contains(low); }));
+        }
+
+        Words scratchA {};
+        Words scratchB {};
+        const std::uint64_t* wa { a.words(scratchA) };
+        const std::uint64_t* wb { b.words(scratchB) };
+        std::uint64_t count { 0 };
+        for (std::size_t w { 0 }; w < chunkWords; ++w)
+            count += static_cast<std::uint64_t>(popcount(wa[w] & wb[w]));
+        return count;
+    }
+
+    static RoaringBitmap combine(const RoaringBitmap& a, const RoaringBitmap& b, Operation operation)
+    {
+        RoaringBitmap result {};
+        std::size_t i { 0 };
+        std::size_t j { 0 };
+        auto append = [&result](std::uint16_t key, Container&& container)
+        {
+            if (container.cardinality == 0)
+                return;
+            result.m_keys.push_back(key);
+            result.m_containers.push_back(std::move(container));
+        };
+
+        while (i < a.m_keys.size() || j < b.m_keys.size())
+        {
+            const bool inA { i < a.m_keys.size() && (j == b.m_keys.size() || a.m_keys[i] <= b.m_keys[j]) };
+            const bool inB { j < b.m_keys.size() && (i == a.m_keys.size() || b.m_keys[j] <= a.m_keys[i]) };
+            if (inA && inB)
+            {
+                append(a.m_keys[i], combine(a.m_containers[i], b.m_containers[j], operation));
+                ++i;
+                ++j;
+            }
+            else if (inA)
+            {
+                // a chunk only a has: kept by union and difference
+                if (operation != Operation::intersection)
+                    append(a.m_keys[i], Container{ a.m_containers[i] });
+                ++i;
+            }
+            else
+            {
+                if (operation == Operation::union_)
+                    append(b.m_keys[j], Container{ b.m_containers[j] });
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    Container& containerFor(std::uint16_t key)
+    {
+        // ids added in increasing order only ever touch the last container
+        if (m_keys.empty() || key > m_keys.back())
+        {
+            m_keys.push_back(key);
+            m_containers.emplace_back();
+            return m_containers.back();
+        }
+        const auto it { std::lower_bound(m_keys.begin(), m_keys.end(), key) };
+        const auto index { static_cast<std::size_t>(it - m_keys.begin()) };
+        if (it == m_keys.end() || *it != key)
+        {
+            m_keys.insert(it, key);
+            m_containers.insert(m_containers.begin() + static_cast<std::ptrdiff_t>(index), Container{});
+        }
+        return m_containers[index];
+    }
+
+public:
+    void add(std::uint32_t id)
+    {
+        containerFor(static_cast<std::uint16_t>(id >> 16)).add(static_cast<std::uint16_t>(id & 0xFFFF));
+    }
+
+    // Adds every id of [begin, end)
+    void addRange(std::uint32_t begin, std::uint32_t end)
+    {
+        RoaringBitmap range {};
+        for (std::uint64_t chunkBegin { begin }; chunkBegin < end; )
+        {
+            const std::uint64_t chunkEnd { std::min<std::uint64_t>(end, (chunkBegin | 0xFFFF) + 1) };
+            Container run {};
+            run.type = Type::run;
+            run.cardinality = static_cast<std::uint32_t>(chunkEnd - chunkBegin);
+            run.runs.push_back({ static_cast<std::uint16_t>(chunkBegin & 0xFFFF), static_cast<std::uint16_t>(chunkEnd - chunkBegin - 1) });
+            range.m_keys.push_back(static_cast<std::uint16_t>(chunkBegin >> 16));
+            range.m_containers.push_back(std::move(run));
+            chunkBegin = chunkEnd;
+        }
+        *this = combine(*this, range, Operation::union_);
+    }
+
+    bool contains(std::uint32_t id) const
+    {
+        const auto key { static_cast<std::uint16_t>(id >> 16) };
+        const auto it { std::lower_bound(m_keys.begin(), m_keys.end(), key) };
+        if (it == m_keys.end() || *it != key)
+            return false;
+        return m_containers[static_cast<std::size_t>(it - m_keys.begin())].contains(static_cast<std::uint16_t>(id & 0xFFFF));
+    }
+
+    std::uint64_t cardinality() const
+    {
+        std::uint64_t total { 0 };
+        for (const Container& container : m_containers)
+            total += container.cardinality;
+        return total;
+    }
+
+    bool empty() const { return m_containers.empty(); }
+
+    // Turns the containers made of few long ranges into run containers, when that is smaller
+    void runOptimize()
+    {
+        for (Container& container : m_containers)
+        {
+            if (container.type == Type::run)
+                continue;
+
+            Words scratch {};
+            const std::uint64_t* words { container.words(scratch) };
+
+            // a run starts at every set bit whose lower neighbour is clear
+            std::size_t runCount { 0 };
+            std::uint64_t carry { 0 };
+            for (std::size_t w { 0 }; w < chunkWords; ++w)
+            {
+                runCount += static_cast<std::size_t>(popcount(words[w] & ~((words[w] << 1) | carry)));
+                carry = words[w] >> 63;
+            }
+
+            const std::size_t currentBytes { container.type == Type::array ? container.cardinality * sizeof(std::uint16_t) : chunkWords * 8 };
+            if (runCount * sizeof(Run) >= currentBytes)
+                continue;
+
+            std::vector<Run> runs {};
+            runs.reserve(runCount);
+            std::uint32_t low { 0 };
+            while (low < 65536)
+            {
+                // skip the clear bits, then count the set ones
+                while (low < 65536 && !((words[low / 64] >> (low % 64)) & 1))
+                    low = (words[low / 64] >> (low % 64)) == 0 ? (low / 64 + 1) * 64 : low + 1;
+                if (low >= 65536)
+                    break;
+                const std::uint32_t start { low };
+                while (low < 65536 && ((words[low / 64] >> (low % 64)) & 1))
+                    low = (~words[low / 64] >> (low % 64)) == 0 ? (low / 64 + 1) * 64 : low + 1;
+                runs.push_back({ static_cast<std::uint16_t>(start), static_cast<std::uint16_t>(low - start - 1) });
+            }
+
+            container.runs = std::move(runs);
+            container.type = Type::run;
+            container.array.clear();
+            container.array.shrink_to_fit();
+            container.bitmap.clear();
+            container.bitmap.shrink_to_fit();
+        }
+    }
+
+    std::size_t sizeInBytes() const
+    {
+        std::size_t bytes { m_keys.capacity() * sizeof(std::uint16_t) + m_containers.capacity() * sizeof(Container) };
+        for (const Container& container : m_containers)
+            bytes += container.sizeInBytes();
+        return bytes;
+    }
+
+    // Calls fn(id) for every id, in increasing order
+    template <typename F>
+    void forEach(F fn) const
+    {
+        for (std::size_t c { 0 }; c < m_containers.size(); ++c)
+        {
+            const std::uint32_t high { std::uint32_t{ m_keys[c] } << 16 };
+            const Container& container { m_containers[c] };
+            switch (container.type)
+            {
+                case Type::array:
+                    for (const std::uint16_t low : container.array)
+                        fn(high | low);
+                    break;
+                case Type::bitmap:
+                    for (std::size_t w { 0 }; w < chunkWords; ++w)
+                        for (std::uint64_t word { container.bitmap[w] }; word != 0; word &= word - 1)
+                            fn(high | static_cast<std::uint32_t>(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word))));
+                    break;
+                case Type::run:
+                    for (const Run& run : container.runs)
+                        for (std::uint32_t low { run.start }; low <= std::uint32_t{ run.start } + run.length; ++low)
+                            fn(high | low);
+                    break;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> toVector() const
+    {
+        std::vector<std::uint32_t> ids {};
+        ids.reserve(static_cast<std::size_t>(cardinality()));
+        forEach([&ids](std::uint32_t id) { ids.push_back(id); });
+        return ids;
+    }
+
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, Operation::intersection); }
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, Operation::union_); }
+
+    // The ids of a that are not in b
+    friend RoaringBitmap andNot(const RoaringBitmap& a, const RoaringBitmap& b) { return combine(a, b, Operation::difference); }
+
+    // cardinality() of a & b, without building it
+    friend std::uint64_t andCardinality(const RoaringBitmap& a, const RoaringBitmap& b)
+    {
+        std::uint64_t total { 0 };
+        std::size_t i { 0 };
+        std::size_t j { 0 };
+        while (i < a.m_keys.size() && j < b.m_keys.size())
+        {
+            if (a.m_keys[i] < b.m_keys[j])
+                ++i;
+            else if (b.m_keys[j] < a.m_keys[i])
+                ++j;
+            else
+                total += intersectionCardinality(a.m_containers[i++], b.m_containers[j++]);
+        }
+        return total;
+    }
+};
+
+#endif
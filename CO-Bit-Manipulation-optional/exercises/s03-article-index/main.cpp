@@ -0,0 +1,258 @@
+// The article flags of s03 for 100 million articles: a compressed bitmap per flag
+// Build with: clang++ -std=c++17 -O2 -mpopcnt main.cpp -o index
+// Run with:   ./index                          checks, then the queries on 1 million articles
+//             ./index --benchmark [articles]   the same on 100 million articles (or the count given)
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "FlagIndex.h"
+#include "FlagSet.h"
+#include "RoaringBitmap.h"
+
+enum class ArticleOption
+{
+    viewed,
+    edited,
+    favorited,
+    shared,
+    deleted,
+    count,
+};
+
+using ArticleFlags = FlagSet<ArticleOption>;
+
+// The same ids as a RoaringBitmap and as one bool per id
+struct TestSet
+{
+    RoaringBitmap bitmap {};
+    std::vector<bool> reference {};
+};
+
+constexpr std::uint32_t testIds { 5 * 65536 + 123 };
+
+// Chunks in every container form: sparse (array), dense (bitmap), ranges (run after runOptimize())
+TestSet makeTestSet(std::mt19937& rng, bool optimize)
+{
+    TestSet set { {}, std::vector<bool>(testIds) };
+    for (std::uint32_t id { 0 }; id < testIds; ++id)
+    {
+        const std::uint32_t chunk { id >> 16 };
+        bool present {};
+        switch ((chunk + rng()) % 4)
+        {
+            case 0: present = rng() % 64 == 0; break;
+            case 1: present = rng() % 2 == 0; break;
+            case 2: present = (id / 1000) % 3 == 0; break;
+            default: present = false; break;
+        }
+        if (present)
+        {
+            set.bitmap.add(id);
+            set.reference[id] = true;
+        }
+    }
+    if (optimize)
+        set.bitmap.runOptimize();
+    return set;
+}
+
+void checkEqual(const RoaringBitmap& bitmap, const std::vector<bool>& reference)
+{
+    std::vector<std::uint32_t> expected {};
+    for (std::uint32_t id { 0 }; id < reference.size(); ++id)
+    {
+        if (reference[id])
+            expected.push_back(id);
+    }
+    assert(bitmap.toVector() == expected);
+    assert(bitmap.cardinality() == expected.size());
+    for (std::uint32_t id { 0 }; id < reference.size(); id += 7)
+        assert(bitmap.contains(id) == reference[id]);
+}
+
+void checkBitmap()
+{
+    std::mt19937 rng { 42 };
+    for (int round { 0 }; round < 4; ++round)
+    {
+        const TestSet a { makeTestSet(rng, round & 1) };
+        const TestSet b { makeTestSet(rng, round & 2) };
+        checkEqual(a.bitmap, a.reference);
+
+        std::vector<bool> both(testIds);
+        std::vector<bool> either(testIds);
+        std::vector<bool> onlyA(testIds);
+        std::uint64_t bothCount { 0 };
+        for (std::uint32_t id { 0 }; id < testIds; ++id)
+        {
+            both[id] = a.reference[id] && b.reference[id];
+            either[id] = a.reference[id] || b.reference[id];
+            onlyA[id] = a.reference[id] && !b.reference[id];
+            bothCount += both[id];
+        }
+        checkEqual(a.bitmap & b.bitmap, both);
+        checkEqual(a.bitmap | b.bitmap, either);
+        checkEqual(andNot(a.bitmap, b.bitmap), onlyA);
+        assert(andCardinality(a.bitmap, b.bitmap) == bothCount);
+    }
+
+    // out of order, repeated and past the end of a run
+    RoaringBitmap bitmap {};
+    bitmap.addRange(100, 70000);
+    bitmap.add(70000);
+    bitmap.add(5);
+    bitmap.add(5);
+    bitmap.add(4'000'000'000u);
+    bitmap.add(3);
+    std::vector<bool> reference(70001);
+    for (std::uint32_t id { 100 }; id <= 70000; ++id)
+        reference[id] = true;
+    reference[5] = reference[3] = true;
+    assert(bitmap.contains(4'000'000'000u) && bitmap.cardinality() == 69901 + 3);
+    RoaringBitmap last {};
+    last.add(4'000'000'000u);
+    checkEqual(andNot(bitmap, last), reference);
+
+    // a range costs a few bytes once optimized
+    RoaringBitmap range {};
+    for (std::uint32_t id { 1'000'000 }; id < 2'000'000; ++id)
+        range.add(id);
+    const std::size_t before { range.sizeInBytes() };
+    range.runOptimize();
+    assert(range.cardinality() == 1'000'000 && range.sizeInBytes() < before / 20);
+    assert(range.contains(1'000'000) && range.contains(1'999'999) && !range.contains(2'000'000));
+}
+
+void checkIndex()
+{
+    std::mt19937 rng { 7 };
+    std::vector<ArticleFlags> articles(200'000);
+    FlagIndex<ArticleOption> index {};
+    for (std::uint32_t id { 0 }; id < articles.size(); ++id)
+    {
+        articles[id] = ArticleFlags::fromBits(rng() & rng());
+        index.add(id, articles[id]);
+    }
+    index.runOptimize();
+
+    const ArticleFlags favorited { ArticleOption::favorited };
+    const ArticleFlags viewedAndEdited { ArticleOption::viewed, ArticleOption::edited };
+    const ArticleFlags deleted { ArticleOption::deleted };
+    std::vector<std::uint32_t> expected {};
+    std::uint64_t expectedPair { 0 };
+    std::uint64_t expectedNotDeleted { 0 };
+    for (std::uint32_t id { 0 }; id < articles.size(); ++id)
+    {
+        if (id % 101 == 0)
+            assert(index.get(id) == articles[id]);
+        if (articles[id].contains(favorited) && !articles[id].test(ArticleOption::deleted))
+            expected.push_back(id);
+        expectedPair += articles[id].contains(viewedAndEdited);
+        expectedNotDeleted += !articles[id].test(ArticleOption::deleted);
+    }
+    assert(index.size() == articles.size());
+    assert(index.select(favorited, deleted).toVector() == expected);
+    assert(index.count(favorited, deleted) == expected.size());
+    assert(index.count(viewedAndEdited) == expectedPair);
+    assert(index.count({}, deleted) == expectedNotDeleted);
+    assert(index.count(favorited, favorited) == 0);
+}
+
+void benchmark(std::uint32_t articles)
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    // The older articles have all been viewed, the others by chance; deletions come in blocks
+    // (a spam wave, a removed author) plus a few single ones; the other flags are rare.
+    constexpr std::uint8_t option_viewed { 0x01 };
+    constexpr std::uint8_t option_edited { 0x02 };
+    constexpr std::uint8_t option_favorited { 0x04 };
+    constexpr std::uint8_t option_shared { 0x08 };
+    constexpr std::uint8_t option_deleted { 0x10 };
+
+    std::mt19937_64 rng { 42 };
+    std::vector<std::uint8_t> bytes(articles);
+    FlagIndex<ArticleOption> index {};
+    bool blockDeleted { false };
+    for (std::uint32_t id { 0 }; id < articles; ++id)
+    {
+        const std::uint64_t r { rng() };
+        if (id % 10'000 == 0)
+            blockDeleted = (r >> 40) % 50 == 0;
+
+        std::uint8_t flags { 0 };
+        if (id < articles / 10 * 7 || (r & 1))
+            flags |= option_viewed;
+        if ((r >> 1) % 1024 < 31)
+            flags |= option_edited;
+        if ((r >> 11) % 1024 < 10)
+            flags |= option_favorited;
+        if ((r >> 21) % 1024 < 5)
+            flags |= option_shared;
+        if (blockDeleted || (r >> 31) % 1024 == 0)
+            flags |= option_deleted;
+
+        bytes[id] = flags;
+        index.add(id, ArticleFlags::fromBits(flags));
+    }
+    index.runOptimize();
+
+    std::cout << articles << " articles:\n"
+              << "  one byte per article: " << bytes.size() / 1e6 << " MB\n"
+              << "  FlagIndex:            " << index.sizeInBytes() / 1e6 << " MB\n";
+
+    // Each query on the bytes, then on the index
+    auto compare = [&bytes](const char* name, auto byteMatch, auto indexCount)
+    {
+        auto start { Clock::now() };
+        std::uint64_t expected { 0 };
+        for (const std::uint8_t flags : bytes)
+            expected += byteMatch(flags);
+        const Ms byteTime { Clock::now() - start };
+
+        start = Clock::now();
+        const std::uint64_t count { indexCount() };
+        const Ms indexTime { Clock::now() - start };
+
+        assert(count == expected);
+        std::cout << "  " << name << " (" << count << "): " << byteTime.count() << " ms on the bytes, "
+                  << indexTime.count() << " ms on the index\n";
+    };
+
+    compare("favorited and not deleted",
+        [](std::uint8_t flags) { return (flags & (option_favorited | option_deleted)) == option_favorited; },
+        [&index] { return index.count({ ArticleOption::favorited }, { ArticleOption::deleted }); });
+    compare("viewed and edited",
+        [](std::uint8_t flags) { return (flags & (option_viewed | option_edited)) == (option_viewed | option_edited); },
+        [&index] { return index.count({ ArticleOption::viewed, ArticleOption::edited }); });
+    compare("shared or favorited",
+        [](std::uint8_t flags) { return (flags & (option_shared | option_favorited)) != 0; },
+        [&index] { return (index.articles(ArticleOption::shared) | index.articles(ArticleOption::favorited)).cardinality(); });
+    compare("not deleted",
+        [](std::uint8_t flags) { return (flags & option_deleted) == 0; },
+        [&index] { return index.count({}, { ArticleOption::deleted }); });
+}
+
+int main(int argc, char* argv[])
+{
+    checkBitmap();
+    checkIndex();
+
+    if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+    {
+        const unsigned long articles { argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100'000'000ul };
+        benchmark(static_cast<std::uint32_t>(articles > 0 ? articles : 1));
+        return 0;
+    }
+
+    benchmark(1'000'000u);
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+// Fast binary and hexadecimal text for integers of any width and for whole buffers
+//
+// print8BitBinary() divides twice and calls operator<< once per bit. Here:
+// * a byte becomes its 8 binary digits in one step: an 8-byte copy from a 256-entry table, or,
+//   with BMI2 (-mbmi2), a PDEP that spreads the 8 bits over the 8 bytes of a word;
+// * a byte becomes its 2 hex digits with one 2-byte copy from a table;
+// * binaryDump() turns 4 bytes into 32 digits per AVX2 instruction sequence (-mavx2): broadcast
+//   the bytes, keep one bit per lane, compare, add '0';
+// * everything writes into a buffer supplied by the caller and returns the end of the text, so
+//   nothing is allocated and large dumps are written with one output call.
+// Digit groups ("1010 0101") are counted from the last (least significant) digit and inserted in
+// a second pass over the digits, except by binaryDump() for groups of whole bytes, which are
+// written directly.
+
+#ifndef BINARYFORMAT_H
+#define BINARYFORMAT_H
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace BinaryFormat
+{
+    // size digits per group, separated by separator; size 0: no groups
+    struct Grouping
+    {
+        std::size_t size { 0 };
+        char separator { ' ' };
+    };
+
+    // Length of the text for this many digits
+    constexpr std::size_t groupedLength(std::size_t digits, Grouping grouping = {})
+    {
+        if (grouping.size == 0 || digits == 0)
+            return digits;
+        return digits + (digits - 1) / grouping.size;
+    }
+
+    // Buffer sizes needed by toBinary() and toHex() for a T
+    template <typename T>
+    constexpr std::size_t binaryLength(Grouping grouping = {}) { return groupedLength(sizeof(T) * CHAR_BIT, grouping); }
+
+    template <typename T>
+    constexpr std::size_t hexLength(Grouping grouping = {}) { return groupedLength(sizeof(T) * 2, grouping); }
+
+    namespace detail
+    {
+        struct ByteDigits
+        {
+            char binary[8] {};
+            char hexLower[2] {};
+            char hexUpper[2] {};
+        };
+
+        constexpr std::array<ByteDigits, 256> makeTable()
+        {
+            std::array<ByteDigits, 256> table {};
+            for (unsigned byte { 0 }; byte < 256; ++byte)
+            {
+                for (unsigned bit { 0 }; bit < 8; ++bit)
+                    table[byte].binary[bit] = static_cast<char>('0' + ((byte >> (7 - bit)) & 1));
+                table[byte].hexLower[0] = "0123456789abcdef"[byte >> 4];
+                table[byte].hexLower[1] = "0123456789abcdef"[byte & 15];
+                table[byte].hexUpper[0] = "0123456789ABCDEF"[byte >> 4];
+                table[byte].hexUpper[1] = "0123456789ABCDEF"[byte & 15];
+            }
+            return table;
+        }
+
+        inline constexpr std::array<ByteDigits, 256> table { makeTable() };
+
+        // The 8 binary digits of byte at out[0, 8)
+        inline void byteToBinary(unsigned byte, char* out)
+        {
+#if defined(__BMI2__)
+            // bit i to the lowest bit of byte i, then most significant bit first in memory
+            const std::uint64_t bits { _pdep_u64(byte, 0x0101010101010101ull) };
+            const std::uint64_t digits { __builtin_bswap64(bits) | 0x3030303030303030ull };
+            std::memcpy(out, &digits, 8);
+#else
+            std::memcpy(out, table[byte].binary, 8);
+#endif
+        }
+
+        // Spreads the digits [begin, begin + digits) into groups, in place; returns the new end.
+        // The buffer must have room for groupedLength(digits, grouping) characters.
+        inline char* insertSeparators(char* begin, std::size_t digits, Grouping grouping)
+        {
+            const std::size_t length { groupedLength(digits, grouping) };
+            if (length == digits)
+                return begin + digits;
+
+            // from the back, so every group moves right by the number of separators before it
+            std::size_t from { digits };
+            std::size_t to { length };
+            while (from > 0)
+            {
+                const std::size_t size { std::min(grouping.size, from) };
+                from -= size;
+                to -= size;
+                // the group moves right: copy its last character first (groups are short, no memmove call)
+                for (std::size_t k { size }; k > 0; --k)
+                    begin[to + k - 1] = begin[from + k - 1];
+                if (to > 0)
+                    begin[--to] = grouping.separator;
+            }
+            return begin + length;
+        }
+    }
+
+    // Binary digits of value, all sizeof(T) * 8 of them, most significant first.
+    // out needs room for binaryLength<T>(grouping) characters; returns the end of the text.
+    template <typename T>
+    char* toBinary(T value, char* out, Grouping grouping = {})
+    {
+        static_assert(std::is_integral_v<T>, "toBinary() formats integers");
+        const auto bits { static_cast<std::make_unsigned_t<T>>(value) };
+        for (std::size_t byte { 0 }; byte < sizeof(T); ++byte)
+        {
+            const std::size_t shift { (sizeof(T) - 1 - byte) * CHAR_BIT };
+            detail::byteToBinary(static_cast<unsigned>((bits >> shift) & 0xFF), out + byte * 8);
+        }
+        return detail::insertSeparators(out, sizeof(T) * 8, grouping);
+    }
+
+    // Hex digits of value, all sizeof(T) * 2 of them, most significant first
+    template <typename T>
+    char* toHex(T value, char* out, Grouping grouping = {}, bool upperCase = false)
+    {
+        static_assert(std::is_integral_v<T>, "toHex() formats integers");
+        const auto bits { static_cast<std::make_unsigned_t<T>>(value) };
+        for (std::size_t byte { 0 }; byte < sizeof(T); ++byte)
+        {
+            const std::size_t shift { (sizeof(T) - 1 - byte) * CHAR_BIT };
+            const auto& digits { detail::table[(bits >> shift) & 0xFF] };
+            std::memcpy(out + byte * 2, upperCase ? digits.hexUpper : digits.hexLower, 2);
+        }
+        return detail::insertSeparators(out, sizeof(T) * 2, grouping);
+    }
+
+    // Binary digits of size bytes of memory, in memory order, each byte most significant bit first.
+    // out needs room for groupedLength(size * 8, grouping) characters.
+    inline char* binaryDump(const void* data, std::size_t size, char* out, Grouping grouping = {})
+    {
+        const auto* bytes { static_cast<const unsigned char*>(data) };
+
+        // groups of whole bytes that also line up with the first byte: write the separators directly
+        if (grouping.size != 0 && grouping.size % 8 == 0 && (size * 8) % grouping.size == 0)
+        {
+            const std::size_t bytesPerGroup { grouping.size / 8 };
+            for (std::size_t i { 0 }; i < size; ++i)
+            {
+                if (i != 0 && i % bytesPerGroup == 0)
+                    *out++ = grouping.separator;
+                detail::byteToBinary(bytes[i], out);
+                out += 8;
+            }
+            return out;
+        }
+
+        std::size_t i { 0 };
+#if defined(__AVX2__)
+        // in each 128-bit lane, bytes 0-7 and 8-15 take a copy of one input byte each...
+        const __m256i spread { _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3) };
+        // ...and keeps the bit that this digit shows
+        const __m256i bitOfDigit { _mm256_set1_epi64x(static_cast<long long>(0x0102040810204080ull)) };
+        const __m256i one { _mm256_set1_epi8(1) };
+        const __m256i zero { _mm256_set1_epi8('0') };
+        for (; i + 4 <= size; i += 4)
+        {
+            std::uint32_t four {};
+            std::memcpy(&four, bytes + i, 4);
+            const __m256i copies { _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(four)), spread) };
+            const __m256i set { _mm256_cmpeq_epi8(_mm256_and_si256(copies, bitOfDigit), bitOfDigit) };
+            const __m256i digits { _mm256_add_epi8(zero, _mm256_and_si256(set, one)) };
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8), digits);
+        }
+#endif
+        for (; i < size; ++i)
+            detail::byteToBinary(bytes[i], out + i * 8);
+        return detail::insertSeparators(out, size * 8, grouping);
+    }
+
+    // Hex digits of size bytes of memory, in memory order
+    inline char* hexDump(const void* data, std::size_t size, char* out, Grouping grouping = {}, bool upperCase = false)
+    {
+        const auto* bytes { static_cast<const unsigned char*>(data) };
+        for (std::size_t i { 0 }; i < size; ++i)
+        {
+            const auto& digits { detail::table[bytes[i]] };
+            std::memcpy(out + i * 2, upperCase ? digits.hexUpper : digits.hexLower, 2);
+        }
+        return detail::insertSeparators(out, size * 2, grouping);
+    }
+
+    // Convenience versions returning a std::string
+    template <typename T>
+    std::string toBinaryString(T value, Grouping grouping = {})
+    {
+        std::string text(binaryLength<T>(grouping), '\0');
+        toBinary(value, text.data(), grouping);
+        return text;
+    }
+
+    template <typename T>
+    std::string toHexString(T value, Grouping grouping = {}, bool upperCase = false)
+    {
+        std::string text(hexLength<T>(grouping), '\0');
+        toHex(value, text.data(), grouping, upperCase);
+        return text;
+    }
+}
+
+#endif
@@ -0,0 +1,183 @@
+// print8BitBinary() vs BinaryFormat
+// Build with: clang++ -std=c++17 -O2 -mavx2 -mbmi2 main.cpp -o binary
+// Run with:   ./binary                  one byte in binary, like s04
+//             ./binary --benchmark      print8BitBinary() vs BinaryFormat on a 16 MiB bitmap
+
+#include <bitset>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BinaryFormat.h"
+
+// The original, writing to any stream, used as the reference
+void printBit(int x, int pow, std::ostream& out)
+{
+    out << ((x / pow) % 2);
+}
+
+void print8BitBinary(int x, std::ostream& out = std::cout)
+{
+    printBit(x, 128, out);
+    printBit(x, 64, out);
+    printBit(x, 32, out);
+    printBit(x, 16, out);
+
+    out << ' ';
+
+    printBit(x, 8, out);
+    printBit(x, 4, out);
+    printBit(x, 2, out);
+    printBit(x, 1, out);
+}
+
+template <typename T>
+void checkValue(T value)
+{
+    constexpr std::size_t bits { sizeof(T) * 8 };
+    const std::string expected { std::bitset<bits>(static_cast<unsigned long long>(static_cast<std::make_unsigned_t<T>>(value))).to_string() };
+    assert(BinaryFormat::toBinaryString(value) == expected);
+
+    // groups of 4 counted from the right, and of 3, which does not divide the width
+    std::string grouped4 {};
+    std::string grouped3 {};
+    for (std::size_t i { 0 }; i < bits; ++i)
+    {
+        if (i > 0 && (bits - i) % 4 == 0)
+            grouped4 += '_';
+        if (i > 0 && (bits - i) % 3 == 0)
+            grouped3 += ' ';
+        grouped4 += expected[i];
+        grouped3 += expected[i];
+    }
+    assert(BinaryFormat::toBinaryString(value, { 4, '_' }) == grouped4);
+    assert(BinaryFormat::toBinaryString(value, { 3 }) == grouped3);
+
+    char hex[32] {};
+    std::snprintf(hex, sizeof(hex), "%0*llx", static_cast<int>(sizeof(T) * 2),
+        static_cast<unsigned long long>(static_cast<std::make_unsigned_t<T>>(value)));
+    assert(BinaryFormat::toHexString(value) == hex);
+}
+
+void checkFormat()
+{
+    for (int x { 0 }; x < 256; ++x)
+    {
+        std::ostringstream original {};
+        print8BitBinary(x, original);
+        assert(BinaryFormat::toBinaryString(static_cast<std::uint8_t>(x), { 4 }) == original.str());
+        checkValue(static_cast<std::uint8_t>(x));
+    }
+
+    std::mt19937_64 rng { 42 };
+    for (int i { 0 }; i < 1000; ++i)
+    {
+        const std::uint64_t r { rng() };
+        checkValue(static_cast<std::uint16_t>(r));
+        checkValue(static_cast<std::int32_t>(r));
+        checkValue(static_cast<std::uint64_t>(r));
+        checkValue(static_cast<std::int64_t>(r));
+    }
+    assert(BinaryFormat::toHexString(0xBEEFu, { 4, '\'' }, true) == "0000'BEEF");
+    assert(BinaryFormat::toBinaryString(-1, { 8 }).size() == BinaryFormat::binaryLength<int>({ 8 }));
+
+    // dumps: every size around the 4-byte SIMD blocks, against the byte-by-byte formatting
+    std::vector<unsigned char> data(67);
+    for (auto& byte : data)
+        byte = static_cast<unsigned char>(rng());
+    for (std::size_t size { 0 }; size <= data.size(); ++size)
+    {
+        std::string expectedBinary {};
+        std::string expectedHex {};
+        for (std::size_t i { 0 }; i < size; ++i)
+        {
+            expectedBinary += BinaryFormat::toBinaryString(data[i]);
+            expectedHex += BinaryFormat::toHexString(data[i]);
+        }
+
+        std::string binary(BinaryFormat::groupedLength(size * 8), '\0');
+        assert(BinaryFormat::binaryDump(data.data(), size, binary.data()) == binary.data() + binary.size());
+        assert(binary == expectedBinary);
+
+        std::string hex(BinaryFormat::groupedLength(size * 2), '\0');
+        BinaryFormat::hexDump(data.data(), size, hex.data());
+        assert(hex == expectedHex);
+
+        // one group per byte
+        std::string grouped(BinaryFormat::groupedLength(size * 8, { 8 }), '\0');
+        BinaryFormat::binaryDump(data.data(), size, grouped.data(), { 8 });
+        for (std::size_t i { 0 }; i < size; ++i)
+            assert(grouped.compare(i * 9, 8, expectedBinary, i * 8, 8) == 0 && (i + 1 == size || grouped[i * 9 + 8] == ' '));
+    }
+}
+
+void benchmark()
+{
+    using Clock = std::chrono::steady_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    // a 16 MiB bitmap, dumped as text
+    constexpr std::size_t size { 16 << 20 };
+    std::vector<unsigned char> bitmap(size);
+    std::mt19937 rng { 42 };
+    for (auto& byte : bitmap)
+        byte = static_cast<unsigned char>(rng());
+
+    // the original is far slower: time a sixteenth of the bitmap
+    auto start { Clock::now() };
+    std::ostringstream original {};
+    for (std::size_t i { 0 }; i < size / 16; ++i)
+        print8BitBinary(bitmap[i], original);
+    const Ms originalTime { (Clock::now() - start) * 16 };
+
+    std::vector<char> text(BinaryFormat::groupedLength(size * 8, { 8 }));
+    start = Clock::now();
+    char* end { text.data() };
+    for (const unsigned char byte : bitmap)
+        end = BinaryFormat::toBinary(byte, end) + 1; // byte by byte, through toBinary()
+    const Ms valueTime { Clock::now() - start };
+
+    start = Clock::now();
+    BinaryFormat::binaryDump(bitmap.data(), size, text.data());
+    const Ms dumpTime { Clock::now() - start };
+
+    start = Clock::now();
+    BinaryFormat::binaryDump(bitmap.data(), size, text.data(), { 8 });
+    const Ms groupedTime { Clock::now() - start };
+
+    const double mb { static_cast<double>(size) / (1 << 20) };
+    std::cout << mb << " MiB bitmap to binary text (MiB of input per second):\n"
+              << "  print8BitBinary():  " << mb / (originalTime.count() / 1000) << " (extrapolated)\n"
+              << "  toBinary() per byte: " << mb / (valueTime.count() / 1000) << '\n'
+              << "  binaryDump():        " << mb / (dumpTime.count() / 1000) << '\n'
+              << "  binaryDump(), grouped: " << mb / (groupedTime.count() / 1000) << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    checkFormat();
+
+    if (argc > 1 && std::string_view{ argv[1] } == "--benchmark")
+    {
+        benchmark();
+        return 0;
+    }
+
+    std::cout << "Enter an integer between 0 and 255: ";
+    int x{};
+    std::cin >> x;
+
+    char text[BinaryFormat::binaryLength<std::uint8_t>({ 4 })] {};
+    const char* end { BinaryFormat::toBinary(static_cast<std::uint8_t>(x), text, { 4 }) };
+    std::cout.write(text, end - text);
+
+    std::cout << '\n';
+
+    return 0;
+}
@@ -1,20 +1,578 @@
 #pragma once
-#include <iostream>
-#include <vector>
+// minitest: TEST_CASE/CHECK and a parallel runner.
+// run(argc, argv) understands:
+//   --jobs=N        worker threads, 0 for one per core (default 1: the tests run in order, on the
+//                   main thread, so tests that share state stay correct; parallel is opt-in)
+//   --shard=I/N     only the tests with index % N == I, so CTest can start N processes
+//   --filter=GLOBS  only the tests whose name matches one of the ':'-separated globs (* and ?)
+//   --slowest=N     how many of the slowest tests to list at the end (default 5)
+//   --list          print the selected test names and exit
+// BENCHMARK(name) cases run with --benchmark instead of the tests, one at a time; a CHECK failing (or
+// an exception) in one is reported like a failed test and the others still run:
+//   --benchmark-samples=N       timed samples per benchmark (default 20)
+//   --benchmark-min-time=MS     calibrated length of one sample (default 10)
+//   --benchmark-json=FILE       write the results as JSON
+//   --benchmark-baseline=FILE   compare with a JSON written earlier; fail when a median is slower by
+//   --benchmark-threshold=PCT   more than PCT percent (default 10)
+// --perf adds hardware counters (Linux perf_event_open) to both: cycles, instructions, cache and
+// branch misses of the test's own thread, printed as IPC and misses per test or per iteration.
+// The file that defines MTEST_MAIN (or MTEST_ALLOCATION_HOOKS, with a main() of its own) also
+// replaces the global operator new/delete to count heap allocations of the calling thread: tests and
+// benchmarks report them, and CHECK_NO_ALLOC{ ... } fails when its block allocates. A block left by
+// break, return or an exception is still checked, but its failure is only reported when the test or benchmark
+// ends (by run(): a main() of its own must call mtest::throwDeferredFailure()).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
 #include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+namespace mtest {
+  // heap allocations made by a thread, counted by the operator new below
+  struct allocCounts { std::size_t allocations = 0, bytes = 0; };
+  inline allocCounts& threadAllocations(){ static thread_local allocCounts c; return c; }
+  inline bool& allocationHooks(){ static bool installed = false; return installed; } // set before main() when they are
+  inline allocCounts allocationsSince(const allocCounts& start){
+    const allocCounts& now = threadAllocations();
+    return {now.allocations - start.allocations, now.bytes - start.bytes};
+  }
+
+  struct test { std::string name; std::function<void()> fn; };
+  inline std::vector<test>& registry(){ static std::vector<test> r; return r; }
+  struct reg {
+    reg(std::function<void()> f){ registry().push_back({"test" + std::to_string(registry().size()), std::move(f)}); }
+    reg(const char* name, std::function<void()> f){ registry().push_back({name, std::move(f)}); }
+  };
+
+  // BENCHMARK cases: the body loops while state.keepRunning(), the harness chooses how many times
+  class perfCounters;
+  struct counts;
+  class state {
+    std::size_t m_remaining, m_iterations;
+    std::chrono::steady_clock::time_point m_start{}, m_end{};
+    perfCounters* m_counters; // null: not counting
+    counts* m_counts;
+    allocCounts m_allocStart{}, m_allocs{};
+    void startCounters();
+    void stopCounters();
+  public:
+    explicit state(std::size_t iterations, perfCounters* counters = nullptr, counts* total = nullptr)
+      : m_remaining(iterations), m_iterations(iterations), m_counters(counters), m_counts(total) {}
+    bool keepRunning(){
+      if (m_remaining == m_iterations){ m_allocStart = threadAllocations(); startCounters(); m_start = std::chrono::steady_clock::now(); } // first call: start the clock
+      if (m_remaining-- > 0) return true;
+      m_end = std::chrono::steady_clock::now();
+      stopCounters();
+      m_allocs = allocationsSince(m_allocStart);
+      return false;
+    }
+    std::size_t iterations() const { return m_iterations; }
+    const allocCounts& allocations() const { return m_allocs; } // made by the timed loop
+    double elapsedNs() const { return std::chrono::duration<double, std::nano>(m_end - m_start).count(); }
+  };
+  struct benchmark { std::string name; std::function<void(state&)> fn; };
+  inline std::vector<benchmark>& benchmarks(){ static std::vector<benchmark> r; return r; }
+  struct benchReg { benchReg(const char* name, std::function<void(state&)> f){ benchmarks().push_back({name, std::move(f)}); } };
+
+  // Makes the compiler keep the computation of value, and keep memory writes, without costing anything
+#if defined(__GNUC__) || defined(__clang__)
+  template <class T> inline void doNotOptimize(const T& value){ asm volatile("" : : "r,m"(value) : "memory"); }
+  inline void clobberMemory(){ asm volatile("" : : : "memory"); }
+#else
+  template <class T> inline void doNotOptimize(const T& value){ static volatile const void* sink; sink = &value; }
+  inline void clobberMemory(){ std::atomic_signal_fence(std::memory_order_seq_cst); }
+#endif
+
+  // thrown by CHECK; the runner prints the message, so parallel tests don't interleave their output
+  struct failure : std::runtime_error { using std::runtime_error::runtime_error; };
+
+  // A CHECK_NO_ALLOC block left by break, return or an exception skips check(), and a destructor
+  // can't throw: the scope leaves its failure here, and the runner fails the test (or benchmark)
+  // with it when it ends
+  inline std::string& deferredFailure(){ static thread_local std::string f; return f; }
+  inline void throwDeferredFailure(){
+    if (deferredFailure().empty()) return;
+    const std::string message = deferredFailure();
+    deferredFailure().clear();
+    throw failure(message);
+  }
+
+  // CHECK_NO_ALLOC: the block runs once, then check() throws if it allocated on this thread
+  class noAllocScope {
+    allocCounts m_start = threadAllocations();
+    const char* m_file; int m_line;
+    bool m_done = false;
+    std::string message(const allocCounts& made) const {
+      const std::string where = std::string(" at ") + m_file + ":" + std::to_string(m_line);
+      if (!allocationHooks()) return "CHECK_NO_ALLOC needs the allocation hooks (MTEST_MAIN or MTEST_ALLOCATION_HOOKS)" + where;
+      return "CHECK_NO_ALLOC failed: " + std::to_string(made.allocations) + " allocation(s), " + std::to_string(made.bytes) + " bytes" + where;
+    }
+  public:
+    noAllocScope(const char* file, int line) : m_file(file), m_line(line) {}
+    noAllocScope(const noAllocScope&) = delete;
+    noAllocScope& operator=(const noAllocScope&) = delete;
+    ~noAllocScope(){
+      if (m_done) return; // left early, by break, return or an exception
+      const allocCounts made = allocationsSince(m_start); // before anything here allocates
+      if (allocationHooks() && made.allocations == 0) return;
+      if (deferredFailure().empty()) deferredFailure() = message(made);
+    }
+    bool pending() const { return !m_done; }
+    void check(){
+      m_done = true;
+      const allocCounts made = allocationsSince(m_start); // before anything here allocates
+      if (allocationHooks() && made.allocations == 0) return;
+      throw failure(message(made));
+    }
+  };
+
+  // CPU time of the calling thread, in seconds
+  inline double threadCpuSeconds(){
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC; // whole process: only right with --jobs=1
+#endif
+  }
+
+  struct counts {
+    bool valid = false;
+    double cycles = 0, instructions = 0, cacheMisses = 0, branchMisses = 0;
+    counts& operator+=(const counts& c){ valid = valid || c.valid; cycles += c.cycles; instructions += c.instructions; cacheMisses += c.cacheMisses; branchMisses += c.branchMisses; return *this; }
+    double ipc() const { return cycles > 0 ? instructions / cycles : 0; }
+  };
+
+  // Hardware counters of the thread that creates the object, as one perf event group (read together).
+  // Opening fails without a PMU (many VMs) or when perf_event_paranoid forbids it: then valid() is false.
+  class perfCounters {
+#if defined(__linux__)
+    static constexpr int eventCount = 4;
+    int m_fds[eventCount] = {-1, -1, -1, -1};
+    int m_error = 0;
+    static long open(std::uint64_t config, int group){
+      perf_event_attr attr{};
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = config;
+      attr.disabled = group == -1; // the group starts and stops with its leader
+      attr.exclude_kernel = 1; // allowed at perf_event_paranoid 2
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0); // this thread, any CPU
+    }
+  public:
+    perfCounters(){
+      const std::uint64_t configs[eventCount] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+      for (int i = 0; i < eventCount; ++i){
+        m_fds[i] = static_cast<int>(open(configs[i], m_fds[0]));
+        if (m_fds[i] < 0){ m_error = errno; close(); return; }
+      }
+    }
+    ~perfCounters(){ close(); }
+    perfCounters(const perfCounters&) = delete;
+    perfCounters& operator=(const perfCounters&) = delete;
+    bool valid() const { return m_fds[0] >= 0; }
+    std::string error() const { return valid() ? "" : std::string("perf_event_open: ") + std::strerror(m_error); }
+    void start(){ if (valid()){ ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP); ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP); } }
+    counts stop(){
+      counts c;
+      if (!valid()) return c;
+      ioctl(m_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+      std::uint64_t data[3 + eventCount] = {}; // count, time enabled, time running, values
+      if (::read(m_fds[0], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) return c;
+      // when the PMU is shared the group only ran part of the time: scale up
+      const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+      c.valid = true;
+      c.cycles = static_cast<double>(data[3]) * scale;
+      c.instructions = static_cast<double>(data[4]) * scale;
+      c.cacheMisses = static_cast<double>(data[5]) * scale;
+      c.branchMisses = static_cast<double>(data[6]) * scale;
+      return c;
+    }
+  private:
+    void close(){ for (int& fd: m_fds){ if (fd >= 0) ::close(fd); fd = -1; } }
+#else
+  public:
+    bool valid() const { return false; }
+    std::string error() const { return "hardware counters need Linux"; }
+    void start(){}
+    counts stop(){ return {}; }
+#endif
+  };
+
+  inline void state::startCounters(){ if (m_counters) m_counters->start(); }
+  inline void state::stopCounters(){ if (m_counters) *m_counts += m_counters->stop(); }
+
+  // with --perf, says once why there won't be any counters
+  inline void checkCounters(bool perf){
+    if (!perf) return;
+    perfCounters probe;
+    if (!probe.valid()) std::cerr << "No hardware counters (" << probe.error() << ")\n";
+  }
+
+  inline void printAllocations(std::ostream& out, const allocCounts& a, double per){
+    if (allocationHooks()) out << "  " << static_cast<double>(a.allocations) / per << " allocs, " << static_cast<double>(a.bytes) / per << " bytes";
+  }
+
+  inline void printCounts(std::ostream& out, const counts& c, double per){
+    if (!c.valid){ out << "  (no counters)"; return; }
+    out << "  ipc " << std::setprecision(3) << c.ipc() << ", " << c.cycles / per << " cycles, " << c.cacheMisses / per
+        << " cache misses, " << c.branchMisses / per << " branch misses" << std::setprecision(6);
+  }
+
+  // glob with * (any run of characters) and ? (any one character)
+  inline bool globMatch(const char* pattern, const char* text){
+    const char* star = nullptr; const char* resume = nullptr;
+    while (*text){
+      if (*pattern == '?' || *pattern == *text){ ++pattern; ++text; }
+      else if (*pattern == '*'){ star = pattern++; resume = text; }
+      else if (star){ pattern = star + 1; text = ++resume; }
+      else return false;
+    }
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+  }
+
+  struct options {
+    unsigned jobs = 1; // 0: one per core
+    std::size_t shardIndex = 0, shardCount = 1;
+    std::vector<std::string> filters;
+    std::size_t slowest = 5;
+    bool list = false;
+    bool benchmark = false;
+    bool perf = false;
+    std::size_t samples = 20;
+    double minSampleMs = 10;
+    std::string jsonPath, baselinePath;
+    double thresholdPercent = 10;
+  };
+
+  // false (after printing why) on an unknown or malformed flag
+  inline bool parseOptions(int argc, char** argv, options& o){
+    for (int i = 1; i < argc; ++i){
+      const std::string arg = argv[i];
+      const auto value = [&arg](const char* flag){ return arg.compare(0, std::strlen(flag), flag) == 0 ? arg.c_str() + std::strlen(flag) : nullptr; };
+      if (const char* v = value("--jobs=")) o.jobs = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+      else if (const char* v = value("--slowest=")) o.slowest = std::strtoul(v, nullptr, 10);
+      else if (const char* v = value("--shard=")){
+        char* slash = nullptr;
+        o.shardIndex = std::strtoul(v, &slash, 10);
+        o.shardCount = *slash == '/' ? std::strtoul(slash + 1, nullptr, 10) : 0;
+        if (o.shardCount == 0 || o.shardIndex >= o.shardCount){ std::cerr << "Bad shard: " << v << " (expected I/N with I < N)\n"; return false; }
+      }
+      else if (const char* v = value("--filter=")){
+        std::stringstream globs(v);
+        for (std::string glob; std::getline(globs, glob, ':');) if (!glob.empty()) o.filters.push_back(glob);
+      }
+      else if (const char* v = value("--benchmark-samples=")) o.samples = std::max<std::size_t>(1, std::strtoul(v, nullptr, 10));
+      else if (const char* v = value("--benchmark-min-time=")) o.minSampleMs = std::strtod(v, nullptr);
+      else if (const char* v = value("--benchmark-json=")) o.jsonPath = v;
+      else if (const char* v = value("--benchmark-baseline=")) o.baselinePath = v;
+      else if (const char* v = value("--benchmark-threshold=")) o.thresholdPercent = std::strtod(v, nullptr);
+      else if (arg == "--benchmark") o.benchmark = true;
+      else if (arg == "--perf") o.perf = true;
+      else if (arg == "--list") o.list = true;
+      else { std::cerr << "Unknown option: " << arg << "\n"; return false; }
+    }
+    return true;
+  }
+
+  inline bool selected(const options& o, std::size_t index, const std::string& name){
+    if (index % o.shardCount != o.shardIndex) return false;
+    if (o.filters.empty()) return true;
+    return std::any_of(o.filters.begin(), o.filters.end(), [&name](const std::string& glob){ return globMatch(glob.c_str(), name.c_str()); });
+  }
+
+  struct result { const test* t = nullptr; bool passed = false; double wallMs = 0, cpuMs = 0; counts hw{}; allocCounts allocs{}; };
+
+  inline int runTests(const options& o){
+    std::vector<result> results;
+    for (std::size_t i = 0; i < registry().size(); ++i)
+      if (selected(o, i, registry()[i].name)) results.push_back({&registry()[i]});
+    if (o.list){ for (auto& r: results) std::cout << r.t->name << "\n"; return 0; }
+    checkCounters(o.perf);
+
+    // workers take the next test from a shared counter; each result has its own slot
+    std::atomic<std::size_t> next{0};
+    std::mutex output;
+    const auto worker = [&]{
+      std::unique_ptr<perfCounters> counters; // counters follow a thread: one set per worker
+      if (o.perf) counters.reset(new perfCounters);
+      for (std::size_t i; (i = next++) < results.size();){
+        result& r = results[i];
+        std::string error;
+        const auto wallStart = std::chrono::steady_clock::now();
+        const double cpuStart = threadCpuSeconds();
+        const allocCounts allocStart = threadAllocations();
+        if (counters) counters->start();
+        deferredFailure().clear();
+        try{ r.t->fn(); throwDeferredFailure(); r.passed = true; }
+        catch(const failure& e){ error = e.what(); }
+        catch(const std::exception& e){ error = std::string("Test threw: ") + e.what(); }
+        catch(...){ error = "Test threw unknown"; }
+        if (counters) r.hw = counters->stop();
+        r.allocs = allocationsSince(allocStart);
+        r.cpuMs = (threadCpuSeconds() - cpuStart) * 1000;
+        r.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+        if (!r.passed){ std::lock_guard<std::mutex> lock(output); std::cerr << "[FAILED] " << r.t->name << ": " << error << "\n"; }
+      }
+    };
+    unsigned jobs = o.jobs ? o.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = static_cast<unsigned>(std::min<std::size_t>(jobs, std::max<std::size_t>(results.size(), 1)));
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned j = 1; j < jobs; ++j) threads.emplace_back(worker);
+    worker();
+    for (auto& t: threads) t.join();
+    const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<const result*> slow;
+    for (auto& r: results) slow.push_back(&r);
+    std::sort(slow.begin(), slow.end(), [](const result* a, const result* b){ return a->wallMs > b->wallMs; });
+    slow.resize(std::min(slow.size(), o.slowest));
+    if (!slow.empty()){
+      std::cout << "Slowest tests (wall / cpu ms):\n";
+      for (auto* r: slow){
+        std::cout << "  " << r->wallMs << " / " << r->cpuMs << "  " << r->t->name;
+        printAllocations(std::cout, r->allocs, 1);
+        if (o.perf) printCounts(std::cout, r->hw, 1);
+        std::cout << "\n";
+      }
+    }
+
+    const auto failed = std::count_if(results.begin(), results.end(), [](const result& r){ return !r.passed; });
+    std::cout << results.size() << " test(s) in " << totalMs << " ms on " << jobs << " thread(s)";
+    if (o.shardCount > 1) std::cout << ", shard " << o.shardIndex << "/" << o.shardCount;
+    std::cout << "\n";
+    if (failed){ std::cerr << failed << " test(s) failed\n"; return 1; }
+    std::cout << "All tests passed\n"; return 0;
+  }
+
+  struct benchResult {
+    std::string name;
+    std::size_t iterations = 0; // per sample
+    double medianNs = 0, madNs = 0, p10Ns = 0, p90Ns = 0, minNs = 0, meanNs = 0; // per iteration
+    counts hw{}; // over all the timed samples
+    allocCounts allocs{};
+    std::size_t countedIterations = 0;
+  };
+
+  // p-th percentile of sorted values, interpolated
+  inline double percentile(const std::vector<double>& sorted, double p){
+    const double at = p / 100 * static_cast<double>(sorted.size() - 1);
+    const std::size_t low = static_cast<std::size_t>(at);
+    const std::size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (at - static_cast<double>(low));
+  }
+
+  inline benchResult measure(const benchmark& b, const options& o){
+    const auto sampleNs = [&b](std::size_t iterations){ state st(iterations); b.fn(st); return st.elapsedNs(); };
+
+    // calibrate: double the iterations until one sample lasts minSampleMs; that also warms up
+    std::size_t iterations = 1;
+    for (double ns = sampleNs(iterations); ns < o.minSampleMs * 1e6 && iterations < (std::size_t{1} << 40);){
+      const double scale = ns > 0 ? std::min(10.0, std::max(2.0, o.minSampleMs * 1e6 / ns * 1.2)) : 10.0;
+      iterations = static_cast<std::size_t>(static_cast<double>(iterations) * scale);
+      ns = sampleNs(iterations);
+    }
+    sampleNs(iterations); // one more warmup sample at the final count
+
+    // the timed samples, with the counters on if asked for
+    std::unique_ptr<perfCounters> counters;
+    if (o.perf) counters.reset(new perfCounters);
+    counts hw;
+    allocCounts allocs;
+    std::vector<double> perIteration;
+    for (std::size_t i = 0; i < o.samples; ++i){
+      state st(iterations, counters.get(), &hw);
+      b.fn(st);
+      allocs.allocations += st.allocations().allocations;
+      allocs.bytes += st.allocations().bytes;
+      perIteration.push_back(st.elapsedNs() / static_cast<double>(iterations));
+    }
+    std::sort(perIteration.begin(), perIteration.end());
+
+    benchResult r;
+    r.name = b.name;
+    r.iterations = iterations;
+    r.hw = hw;
+    r.allocs = allocs;
+    r.countedIterations = iterations * o.samples;
+    r.medianNs = percentile(perIteration, 50);
+    r.p10Ns = percentile(perIteration, 10);
+    r.p90Ns = percentile(perIteration, 90);
+    r.minNs = perIteration.front();
+    for (double v: perIteration) r.meanNs += v / static_cast<double>(perIteration.size());
+    std::vector<double> deviations;
+    for (double v: perIteration) deviations.push_back(std::abs(v - r.medianNs));
+    std::sort(deviations.begin(), deviations.end());
+    r.madNs = percentile(deviations, 50);
+    return r;
+  }
+
+  inline void writeJson(std::ostream& out, const std::vector<benchResult>& results){
+    out << "{\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i){
+      const benchResult& r = results[i];
+      out << (i ? "," : "") << "\n    { \"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+          << ", \"median_ns\": " << r.medianNs << ", \"mad_ns\": " << r.madNs << ", \"p10_ns\": " << r.p10Ns
+          << ", \"p90_ns\": " << r.p90Ns << ", \"min_ns\": " << r.minNs << ", \"mean_ns\": " << r.meanNs;
+      const double per = static_cast<double>(r.countedIterations);
+      if (allocationHooks())
+        out << ", \"allocs\": " << static_cast<double>(r.allocs.allocations) / per << ", \"alloc_bytes\": " << static_cast<double>(r.allocs.bytes) / per;
+      if (r.hw.valid){
+        out << ", \"ipc\": " << r.hw.ipc() << ", \"cycles\": " << r.hw.cycles / per << ", \"instructions\": " << r.hw.instructions / per
+            << ", \"cache_misses\": " << r.hw.cacheMisses / per << ", \"branch_misses\": " << r.hw.branchMisses / per;
+      }
+      out << " }";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  // The medians of a file written by writeJson(), by name
+  inline std::vector<std::pair<std::string, double>> readBaseline(std::istream& in){
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::pair<std::string, double>> medians;
+    for (std::size_t at = text.find("\"name\": \""); at != std::string::npos; at = text.find("\"name\": \"", at)){
+      at += std::strlen("\"name\": \"");
+      const std::size_t nameEnd = text.find('"', at);
+      const std::size_t median = text.find("\"median_ns\": ", nameEnd);
+      if (nameEnd == std::string::npos || median == std::string::npos) break;
+      medians.emplace_back(text.substr(at, nameEnd - at), std::strtod(text.c_str() + median + std::strlen("\"median_ns\": "), nullptr));
+      at = median;
+    }
+    return medians;
+  }
+
+  inline int runBenchmarks(const options& o){
+    std::vector<const benchmark*> selection;
+    for (std::size_t i = 0; i < benchmarks().size(); ++i)
+      if (selected(o, i, benchmarks()[i].name)) selection.push_back(&benchmarks()[i]);
+    if (o.list){ for (auto* b: selection) std::cout << b->name << "\n"; return 0; }
+    checkCounters(o.perf);
+
+    std::vector<std::pair<std::string, double>> baseline;
+    if (!o.baselinePath.empty()){
+      std::ifstream in(o.baselinePath);
+      if (!in){ std::cerr << "Cannot read the baseline " << o.baselinePath << "\n"; return 2; }
+      baseline = readBaseline(in);
+    }
+
+    std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(14) << "median ns" << std::setw(12) << "mad ns"
+              << std::setw(14) << "p10 ns" << std::setw(14) << "p90 ns" << std::setw(14) << "iterations" << (baseline.empty() ? "" : "  vs baseline") << "\n";
+    std::vector<benchResult> results;
+    int regressions = 0, failures = 0;
+    for (auto* b: selection){
+      // benchmarks run one at a time on this thread: parallel ones would disturb each other
+      benchResult r;
+      std::string error;
+      deferredFailure().clear();
+      try{ r = measure(*b, o); throwDeferredFailure(); }
+      catch(const failure& e){ error = e.what(); }
+      catch(const std::exception& e){ error = std::string("Benchmark threw: ") + e.what(); }
+      catch(...){ error = "Benchmark threw unknown"; }
+      if (!error.empty()){ ++failures; std::cout << std::flush; std::cerr << "[FAILED] " << b->name << ": " << error << "\n"; continue; }
+      results.push_back(r);
+      std::cout << std::left << std::setw(32) << r.name << std::right << std::setw(14) << r.medianNs << std::setw(12) << r.madNs
+                << std::setw(14) << r.p10Ns << std::setw(14) << r.p90Ns << std::setw(14) << r.iterations;
+      const auto old = std::find_if(baseline.begin(), baseline.end(), [&r](const std::pair<std::string, double>& e){ return e.first == r.name; });
+      if (old != baseline.end() && old->second > 0){
+        const double change = (r.medianNs / old->second - 1) * 100;
+        const bool regressed = change > o.thresholdPercent;
+        regressions += regressed;
+        std::cout << "  " << std::showpos << change << std::noshowpos << "%" << (regressed ? " REGRESSION" : "");
+      }
+      printAllocations(std::cout, r.allocs, static_cast<double>(r.countedIterations)); // per iteration
+      if (o.perf) printCounts(std::cout, r.hw, static_cast<double>(r.countedIterations));
+      std::cout << "\n";
+    }
+
+    if (!o.jsonPath.empty()){
+      std::ofstream out(o.jsonPath);
+      writeJson(out, results);
+      if (!out){ std::cerr << "Cannot write " << o.jsonPath << "\n"; return 2; }
+    }
+    if (failures){ std::cerr << failures << " benchmark(s) failed\n"; return 1; }
+    if (regressions){ std::cerr << regressions << " benchmark(s) slower than the baseline by more than " << o.thresholdPercent << "%\n"; return 1; }
+    return 0;
+  }
+
+  inline int run(int argc, char** argv){
+    options o;
+    if (!parseOptions(argc, argv, o)) return 2;
+    return o.benchmark ? runBenchmarks(o) : runTests(o);
+  }
+  inline int run(){ return run(0, nullptr); }
+}
+#define TEST_CASE(name) static void name(); static mtest::reg reg_##name{#name, name}; static void name()
+#define BENCHMARK(name) static void name(mtest::state&); static mtest::benchReg benchReg_##name{#name, name}; static void name(mtest::state& state)
+#define CHECK_NO_ALLOC for (mtest::noAllocScope noAllocScope_{__FILE__, __LINE__}; noAllocScope_.pending(); noAllocScope_.check())
+#define CHECK(cond) do{ if(!(cond)){ throw mtest::failure("CHECK failed: " #cond " at " __FILE__ ":" + std::to_string(__LINE__)); } }while(0)
+// define MTEST_MAIN in one source file for a main() that calls run(argc, argv)
+#ifdef MTEST_MAIN
+int main(int argc, char** argv){ return mtest::run(argc, argv); }
+#endif
+// the replaced operator new/delete count into threadAllocations(); they may only be defined once per program
+#if defined(MTEST_MAIN) || defined(MTEST_ALLOCATION_HOOKS)
 namespace mtest {
-  inline std::vector<std::function<void()>>& registry(){ static std::vector<std::function<void()>> r; return r; }
-  struct reg { reg(std::function<void()> f){ registry().push_back(std::move(f)); } };
-  inline int run(){
-    int failed=0;
-    for (auto& f: registry()){
-      try{ f(); } catch(const std::exception& e){ std::cerr<<"Test threw: "<<e.what()<<"\n"; failed++; }
-      catch(...){ std::cerr<<"Test threw unknown\n"; failed++; }
+  static const bool allocationHooksInstalled = (allocationHooks() = true);
+  inline void* allocate(std::size_t size, std::size_t alignment){
+    allocCounts& c = threadAllocations();
+    ++c.allocations; c.bytes += size;
+    if (size == 0) size = 1;
+    if (alignment > alignof(std::max_align_t)) size = (size + alignment - 1) / alignment * alignment; // as aligned_alloc requires
+    for (;;){
+      if (void* p = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, size) : std::malloc(size)) return p;
+      const std::new_handler handler = std::get_new_handler();
+      if (!handler) throw std::bad_alloc();
+      handler();
     }
-    if(failed){ std::cerr<<failed<<" test(s) failed\n"; return 1; }
-    std::cout<<"All tests passed\n"; return 0;
+  }
+  inline void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept {
+    try{ return allocate(size, alignment); } catch(...){ return nullptr; }
   }
 }
-#define TEST_CASE(name) static void name(); static mtest::reg reg_##name{name}; static void name()
-#define CHECK(cond) do{ if(!(cond)){ std::cerr<<"CHECK failed: " #cond " at " __FILE__ ":"<<__LINE__<<"\n"; throw std::runtime_error(\"check failed\"); } }while(0)
+void* operator new(std::size_t size){ return mtest::allocate(size, 0); }
+void* operator new[](std::size_t size){ return mtest::allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a){ return mtest::allocate(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a){ return mtest::allocate(size, static_cast<std::size_t>(a)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return mtest::allocateNoThrow(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return mtest::allocateNoThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return mtest::allocateNoThrow(size, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return mtest::allocateNoThrow(size, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,160 @@
+// minitest's own tests: option parsing, test selection, the allocation hooks and the baseline gate
+// Build with: clang++ -std=c++17 -O2 -pthread selftest.cpp -o minitest_selftest
+#define MTEST_MAIN
+#include "minitest.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <set>
+
+namespace {
+  bool parse(std::vector<std::string> args, mtest::options& o){
+    args.insert(args.begin(), "selftest");
+    std::vector<char*> argv;
+    for (auto& a: args) argv.push_back(&a[0]);
+    return mtest::parseOptions(static_cast<int>(argv.size()), argv.data(), o);
+  }
+
+  std::string tempPath(const char* name){ return (std::filesystem::temp_directory_path() / name).string(); }
+}
+
+TEST_CASE(glob_match){
+  CHECK(mtest::globMatch("*", ""));
+  CHECK(mtest::globMatch("deck_*", "deck_shuffle"));
+  CHECK(mtest::globMatch("?ard", "card"));
+  CHECK(mtest::globMatch("*_turn*", "dealer_turn_bust"));
+  CHECK(!mtest::globMatch("deck_*", "player_deck"));
+  CHECK(!mtest::globMatch("?ard", "ard"));
+}
+
+TEST_CASE(parse_options){
+  mtest::options o;
+  CHECK(parse({}, o) && o.jobs == 1); // sequential unless asked
+  CHECK(parse({"--jobs=4", "--shard=1/3", "--filter=deck_*:card?", "--slowest=2", "--benchmark-threshold=5"}, o));
+  CHECK(o.jobs == 4 && o.shardIndex == 1 && o.shardCount == 3 && o.slowest == 2 && o.thresholdPercent == 5);
+  CHECK(o.filters.size() == 2 && o.filters[0] == "deck_*" && o.filters[1] == "card?");
+
+  mtest::options bad;
+  CHECK(!parse({"--shard=3/3"}, bad));
+  CHECK(!parse({"--shard=1"}, bad));
+  CHECK(!parse({"--no-such-flag"}, bad));
+}
+
+TEST_CASE(shards_cover_every_test_once){
+  mtest::options o;
+  o.shardCount = 3;
+  std::set<std::size_t> seen;
+  for (o.shardIndex = 0; o.shardIndex < o.shardCount; ++o.shardIndex)
+    for (std::size_t i = 0; i < 20; ++i)
+      if (mtest::selected(o, i, "any")) CHECK(seen.insert(i).second);
+  CHECK(seen.size() == 20);
+}
+
+TEST_CASE(filters_select_by_name){
+  mtest::options o;
+  CHECK(parse({"--filter=deck_*:*_bust"}, o));
+  CHECK(mtest::selected(o, 0, "deck_shuffle"));
+  CHECK(mtest::selected(o, 1, "dealer_bust"));
+  CHECK(!mtest::selected(o, 2, "player_turn"));
+  o.shardCount = 2; // filters and shards combine
+  CHECK(!mtest::selected(o, 1, "deck_deal"));
+}
+
+TEST_CASE(allocations_are_counted){
+  const mtest::allocCounts start = mtest::threadAllocations();
+  auto* values = new int[100];
+  mtest::doNotOptimize(values);
+  delete[] values;
+  const mtest::allocCounts made = mtest::allocationsSince(start);
+  CHECK(made.allocations == 1 && made.bytes == 100 * sizeof(int));
+}
+
+TEST_CASE(check_no_alloc_passes){
+  int sink = 0;
+  CHECK_NO_ALLOC { sink += 1; }
+  CHECK(sink == 1);
+}
+
+TEST_CASE(check_no_alloc_fails){
+  std::string message;
+  try{
+    CHECK_NO_ALLOC { std::vector<int> v(10); mtest::doNotOptimize(v); }
+  } catch(const mtest::failure& e){ message = e.what(); }
+  CHECK(message.find("CHECK_NO_ALLOC failed: 1 allocation(s), 40 bytes") == 0);
+}
+
+TEST_CASE(check_no_alloc_left_early){
+  const auto allocateThenReturn = []{ CHECK_NO_ALLOC { std::vector<int> v(10); mtest::doNotOptimize(v); return; } };
+  allocateThenReturn();
+  CHECK(mtest::deferredFailure().find("CHECK_NO_ALLOC failed: 1 allocation(s), 40 bytes") == 0);
+  mtest::deferredFailure().clear();
+
+  for (int i = 0; i < 2; ++i) CHECK_NO_ALLOC { if (i == 0) break; }
+  CHECK(mtest::deferredFailure().empty()); // nothing allocated
+  for (int i = 0; i < 2; ++i) CHECK_NO_ALLOC { std::string s(100, 'x'); mtest::doNotOptimize(s); break; }
+  std::string message;
+  try{ mtest::throwDeferredFailure(); } catch(const mtest::failure& e){ message = e.what(); }
+  CHECK(message.find("CHECK_NO_ALLOC failed: 1 allocation(s)") == 0 && mtest::deferredFailure().empty());
+}
+
+BENCHMARK(selftest_spin){
+  unsigned x = 0;
+  while (state.keepRunning()) mtest::doNotOptimize(++x);
+}
+
+// fails only when benchmark_failure asks, so that --benchmark still passes
+bool failNextBenchmark = false;
+BENCHMARK(selftest_failing){
+  CHECK(!failNextBenchmark);
+  unsigned x = 0;
+  while (state.keepRunning()) mtest::doNotOptimize(++x);
+}
+
+TEST_CASE(baseline_round_trip){
+  mtest::benchResult r;
+  r.name = "spin";
+  r.medianNs = 12.5;
+  std::stringstream json;
+  mtest::writeJson(json, {r});
+  const auto medians = mtest::readBaseline(json);
+  CHECK(medians.size() == 1 && medians[0].first == "spin" && medians[0].second == 12.5);
+}
+
+TEST_CASE(baseline_gate){
+  const std::string path = tempPath("minitest-selftest-baseline.json");
+  mtest::options o;
+  o.benchmark = true;
+  o.samples = 3;
+  o.minSampleMs = 0.05;
+  o.filters = {"selftest_spin"};
+  o.baselinePath = path;
+  const auto gate = [&](double medianNs){
+    mtest::benchResult old;
+    old.name = "selftest_spin";
+    old.medianNs = medianNs;
+    { std::ofstream out(path); mtest::writeJson(out, {old}); }
+    return mtest::runBenchmarks(o);
+  };
+  CHECK(gate(1e-6) == 1); // far slower than the baseline: a regression
+  CHECK(gate(1e9) == 0);
+  std::remove(path.c_str());
+  o.baselinePath = tempPath("minitest-selftest-missing.json");
+  CHECK(mtest::runBenchmarks(o) == 2);
+}
+
+TEST_CASE(benchmark_failure){
+  mtest::options o;
+  o.benchmark = true;
+  o.samples = 3;
+  o.minSampleMs = 0.05;
+  o.filters = {"selftest_failing", "selftest_spin"};
+  std::stringstream errors;
+  std::streambuf* const cerr = std::cerr.rdbuf(errors.rdbuf());
+  failNextBenchmark = true;
+  const int status = mtest::runBenchmarks(o);
+  failNextBenchmark = false;
+  std::cerr.rdbuf(cerr);
+  CHECK(status == 1);
+  CHECK(errors.str().find("[FAILED] selftest_failing: CHECK failed: !failNextBenchmark") == 0);
+  CHECK(errors.str().find("1 benchmark(s) failed") != std::string::npos);
+  CHECK(mtest::runBenchmarks(o) == 0);
+}
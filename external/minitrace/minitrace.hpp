@@ -0,0 +1,186 @@
+#pragma once
+// minitrace: scoped zones recorded per thread, written as Chrome trace-event JSON (open the file in
+// https://ui.perfetto.dev or chrome://tracing).
+//   TRACE_SCOPE("name")   records the enclosing scope: its start and duration
+//   TRACE_FUNCTION()      the same, named after the function
+//   TRACE_INSTANT("name") a point in time
+//   mtrace::setThreadName("worker 1"), mtrace::write("game.trace.json")
+// The macros only record with TRACE_ENABLED defined; without it they expand to nothing, so the
+// instrumentation can stay in the code. Names must outlive the program: string literals.
+// Zones are timed with the TSC on x86 (two reads cost less than one steady_clock::now()) and
+// converted to nanoseconds by write(); elsewhere with steady_clock.
+// Each thread writes to its own ring buffer of TRACE_BUFFER_EVENTS events (default 2^20, 24 MiB),
+// taken on its first event; nothing is locked or allocated after that. A full buffer drops its
+// oldest events, so a long run keeps its end. write() reads the buffers of every thread, exited ones
+// included: call it once the traced threads have finished (or are between zones).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define MTRACE_TSC 1
+#endif
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS (std::size_t{1} << 20)
+#endif
+namespace mtrace {
+  // in ticks: TSC cycles or steady_clock nanoseconds
+  inline std::uint64_t ticks(){
+#ifdef MTRACE_TSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+
+  // taken before the first event: times are written from there, and the tick rate measured since
+  struct clockOrigin { std::uint64_t ticks; std::chrono::steady_clock::time_point time; };
+  inline const clockOrigin& origin(){ static const clockOrigin o{ticks(), std::chrono::steady_clock::now()}; return o; }
+  inline double nsPerTick(){
+#ifdef MTRACE_TSC
+    const clockOrigin& o = origin();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - o.time).count();
+    const std::uint64_t elapsed = ticks() - o.ticks;
+    return elapsed > 0 && ns > 0 ? ns / static_cast<double>(elapsed) : 1;
+#else
+    return 1;
+#endif
+  }
+
+  struct event {
+    const char* name;
+    std::uint64_t start, duration; // ticks; duration instant: a point in time
+    static constexpr std::uint64_t instant = ~std::uint64_t{0};
+  };
+
+  // One thread's events. Only that thread pushes; written counts every event ever pushed.
+  class threadBuffer {
+    static_assert((TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) == 0, "TRACE_BUFFER_EVENTS must be a power of 2");
+    static constexpr std::size_t capacity = TRACE_BUFFER_EVENTS;
+    std::unique_ptr<event[]> m_events{new event[capacity]};
+    std::atomic<std::uint64_t> m_written{0};
+  public:
+    const unsigned tid;
+    std::string name;
+    explicit threadBuffer(unsigned id) : tid(id), name("thread " + std::to_string(id)) {}
+    void push(const event& e){
+      const std::uint64_t n = m_written.load(std::memory_order_relaxed);
+      m_events[n & (capacity - 1)] = e;
+      m_written.store(n + 1, std::memory_order_release); // publishes the event to write()
+    }
+    // the events still in the buffer, oldest first, and how many were dropped
+    std::vector<event> events(std::uint64_t& dropped) const {
+      const std::uint64_t n = m_written.load(std::memory_order_acquire);
+      const std::uint64_t kept = std::min<std::uint64_t>(n, capacity);
+      dropped = n - kept;
+      std::vector<event> out;
+      out.reserve(static_cast<std::size_t>(kept));
+      for (std::uint64_t i = n - kept; i < n; ++i) out.push_back(m_events[i & (capacity - 1)]);
+      return out;
+    }
+  };
+
+  // every thread's buffer, kept after the thread exits
+  struct registry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<threadBuffer>> buffers;
+  };
+  inline registry& threads(){ static registry r; return r; }
+
+  // the calling thread's buffer, registered on its first event (the only lock)
+  inline threadBuffer& local(){
+    static thread_local threadBuffer* buffer = []{
+      origin();
+      registry& r = threads();
+      std::lock_guard<std::mutex> guard(r.lock);
+      r.buffers.push_back(std::make_unique<threadBuffer>(static_cast<unsigned>(r.buffers.size())));
+      return r.buffers.back().get();
+    }();
+    return *buffer;
+  }
+
+  inline void setThreadName(std::string name){ local().name = std::move(name); }
+  inline void instant(const char* name){ threadBuffer& b = local(); b.push({name, ticks(), event::instant}); }
+
+  class zone {
+    threadBuffer& m_buffer; // first: registering the thread takes the clock origin
+    const char* m_name;
+    std::uint64_t m_start;
+  public:
+    explicit zone(const char* name) : m_buffer(local()), m_name(name), m_start(ticks()) {}
+    ~zone(){ const std::uint64_t end = ticks(); m_buffer.push({m_name, m_start, end - m_start}); }
+    zone(const zone&) = delete;
+    zone& operator=(const zone&) = delete;
+  };
+
+  inline void writeString(std::ostream& out, const std::string& s){
+    out << '"';
+    for (char c: s){
+      if (c == '"' || c == '\\') out << '\\' << c;
+      else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+      else out << c;
+    }
+    out << '"';
+  }
+
+  // Chrome trace-event JSON: a complete ("X") event per zone, timestamps in microseconds
+  inline void write(std::ostream& out){
+    registry& r = threads();
+    std::lock_guard<std::mutex> guard(r.lock);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    const auto separator = [&out, &first]{ out << (first ? "\n" : ",\n"); first = false; };
+    const double scale = nsPerTick();
+    const std::uint64_t start = origin().ticks;
+    // ticks to microseconds, with 3 decimals (nanoseconds)
+    const auto micros = [scale](std::uint64_t t){
+      const auto ns = static_cast<std::uint64_t>(static_cast<double>(t) * scale + 0.5);
+      return std::to_string(ns / 1000) + "." + std::to_string(ns % 1000 + 1000).substr(1);
+    };
+    const auto since = [start](std::uint64_t t){ return t > start ? t - start : 0; }; // another core's TSC may lag a little
+    for (const auto& b: r.buffers){
+      std::uint64_t dropped = 0;
+      std::vector<event> events = b->events(dropped);
+      // zones are pushed when they end: in start order, parents come before what they contain
+      std::stable_sort(events.begin(), events.end(), [](const event& x, const event& y){ return x.start < y.start; });
+      separator();
+      out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+      writeString(out, b->name);
+      out << ",\"dropped_events\":" << dropped << "}}";
+      for (const event& e: events){
+        separator();
+        out << "{\"name\":";
+        writeString(out, e.name);
+        if (e.duration == event::instant) out << ",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << micros(since(e.start));
+        else out << ",\"ph\":\"X\",\"ts\":" << micros(since(e.start)) << ",\"dur\":" << micros(e.duration);
+        out << ",\"pid\":1,\"tid\":" << b->tid << "}";
+      }
+    }
+    out << "\n]}\n";
+  }
+
+  // false when the file can't be written
+  inline bool write(const std::string& path){
+    std::ofstream out(path);
+    write(out);
+    return static_cast<bool>(out);
+  }
+}
+#define MTRACE_CONCAT2(a, b) a##b
+#define MTRACE_CONCAT(a, b) MTRACE_CONCAT2(a, b)
+#ifdef TRACE_ENABLED
+// "" name: only a string literal compiles
+#define TRACE_SCOPE(name) const mtrace::zone MTRACE_CONCAT(traceZone_, __LINE__){"" name}
+#define TRACE_FUNCTION() const mtrace::zone MTRACE_CONCAT(traceZone_, __LINE__){__func__}
+#define TRACE_INSTANT(name) mtrace::instant("" name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_FUNCTION() static_cast<void>(0)
+#define TRACE_INSTANT(name) static_cast<void>(0)
+#endif
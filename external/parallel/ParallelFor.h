@@ -0,0 +1,41 @@
+// Shared by the exercises that split packed arrays between threads (Arena, Particles)
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+    // Splits [0, count) in one contiguous chunk per thread and runs fn(begin, end, chunk) on each of them.
+    // Every call joins its threads before returning, so it also acts as a barrier between two phases.
+    template <typename F>
+    void forEachChunk(std::size_t count, unsigned threads, F fn)
+    {
+        if (threads <= 1 || count < threads)
+        {
+            fn(std::size_t{ 0 }, count, 0u);
+            return;
+        }
+
+        std::vector<std::thread> workers {};
+        workers.reserve(threads - 1);
+
+        const std::size_t chunkSize { (count + threads - 1) / threads };
+        for (unsigned chunk { 1 }; chunk < threads; ++chunk)
+        {
+            const std::size_t begin { std::min(count, chunk * chunkSize) };
+            const std::size_t end { std::min(count, begin + chunkSize) };
+            workers.emplace_back(fn, begin, end, chunk);
+        }
+        fn(std::size_t{ 0 }, std::min(count, chunkSize), 0u); // the calling thread takes the first chunk
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+}
+
+#endif